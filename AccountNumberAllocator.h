@@ -0,0 +1,39 @@
+#ifndef ACCOUNTNUMBERALLOCATOR_H
+#define ACCOUNTNUMBERALLOCATOR_H
+
+#include <atomic>
+#include <limits>
+
+using namespace std;
+
+// Hands out increasing account numbers without a lock. Seed it once after
+// loading (observe() every existing account), then allocate() from any thread.
+class AccountNumberAllocator {
+public:
+    explicit AccountNumberAllocator(int first = 1000) : next(first) {}
+    AccountNumberAllocator(const AccountNumberAllocator& other) : next(other.peek()) {}
+    AccountNumberAllocator& operator=(const AccountNumberAllocator& other)
+    {
+        if (this != &other) next.store(other.peek(), memory_order_relaxed);
+        return *this;
+    }
+
+    int allocate() { return next.fetch_add(1, memory_order_relaxed); } // unique per call
+    int peek() const { return next.load(memory_order_relaxed); }       // what allocate() would return
+    void reset(int first) { next.store(first, memory_order_relaxed); }
+
+    // Make sure acct is never handed out again
+    void observe(int acct)
+    {
+        // INT_MAX has no successor; stop there instead of overflowing
+        int target = acct < numeric_limits<int>::max() ? acct + 1 : acct;
+        int cur = next.load(memory_order_relaxed);
+        while (cur < target && !next.compare_exchange_weak(cur, target, memory_order_relaxed)) {
+        }
+    }
+
+private:
+    atomic<int> next;
+};
+
+#endif // ACCOUNTNUMBERALLOCATOR_H
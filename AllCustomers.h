@@ -7,6 +7,15 @@
 #include <fstream>
 #include <iomanip>
 #include <algorithm>
+#include <unordered_map>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <cstdint>
+#include "AccountNumberAllocator.h"
+#include "CowVector.h"
+#include "Revision.h"
 
 using namespace std;
 
@@ -29,12 +38,21 @@ struct Customer {
     }
 };
 
+// Customers are split across shards by a hash of the account number. Each
+// shard has its own reader/writer lock, records and account index, so
+// insertCustomer, replaceCustomer, findCustomer and accountExists can be
+// called from several threads at once and only wait on callers that hit the
+// same shard. The display order (what at(), pages and sorting work on) is a
+// list of shard positions kept on top. Everything that goes through it, and
+// load, save, delete, sort and copy, expects a single thread.
 class AllCustomers {
 public:
     // Constructors / destructors
     AllCustomers();
-    AllCustomers(const AllCustomers& other);            // copy ctor
+    AllCustomers(const AllCustomers& other);            // copy ctor, O(shards): records are shared until written
     AllCustomers& operator=(const AllCustomers& other); // overloaded assignment
+    AllCustomers(AllCustomers&& other) noexcept;
+    AllCustomers& operator=(AllCustomers&& other) noexcept;
     ~AllCustomers();
 
     // File I/O
@@ -42,7 +60,8 @@ public:
     bool saveToFile(const string& filename) const;
 
     // Printing
-    void printAllCustomers() const;
+    void printCustomersPage(size_t page, size_t pageSize, std::ostream& out = std::cout) const; // page is 0-based
+    size_t pageCount(size_t pageSize) const;
     void printCustomerByIndex(size_t index) const;
     void printCustomerByAccount(int acct, std::ostream& out = std::cout) const;
 
@@ -51,26 +70,74 @@ public:
     void sortDescending();
 
     // Search helpers
-    int findIndexByAccount(int acct) const; // returns -1 if not found
-    Customer* findCustomerPtrByAccount(int acct); // returns nullptr if not found
+    int findIndexByAccount(int acct) const; // returns -1 if not found; scans the display order
+    Customer* findCustomerPtrByAccount(int acct); // returns nullptr if not found; don't change accountNumber through it
+    bool findCustomer(int acct, Customer& out) const; // thread safe; copies the record out
+    bool accountExists(int acct) const;               // thread safe
 
     // Add / Update / Delete
     void addCustomer();                 // interactive - add one
     void addMultipleCustomersRecursive(int remaining); // recursive add
     bool updateCustomer(int acct);      // interactive update
     bool deleteCustomer(int acct);      // delete by account
+    bool insertCustomer(const Customer& c);  // thread safe; false if the account already exists
+    bool replaceCustomer(const Customer& c); // thread safe; false if the account doesn't exist
 
     // Utilities
-    int generateUniqueAccountNumber() const;
-    size_t size() const { return customers.size(); }
-    const Customer& at(size_t idx) const { return customers.at(idx); }
+    int generateUniqueAccountNumber() const; // next number the allocator will hand out
+    size_t size() const { return order.size(); }
+    const Customer& at(size_t idx) const { return record(order.at(idx)); }
+    unsigned long revision() const { return revisionCount.load(); } // equal revisions mean equal records, see Revision.h
+
+    // Calls fn(data, length) for every chunk of every shard, so each record
+    // is seen once but not in display order; for scans that don't need it
+    template <typename Fn>
+    void forEachChunk(Fn fn) const
+    {
+        for (const Shard& s : shards) {
+            s.records.forEachChunk([&fn](const Customer* data, size_t len, size_t) { fn(data, len); });
+        }
+    }
 
 private:
-    vector<Customer> customers;
+    static const unsigned shardBits = 5; // 32 shards
+    static const size_t shardCount = size_t{ 1 } << shardBits;
+
+    struct Shard {
+        mutable shared_mutex lock;
+        CowVector<Customer> records;              // copy-on-write chunks, see CowVector.h
+        mutable unordered_map<int, size_t> index; // account -> position in records
+        mutable bool indexed{ true };             // false in a copy until the first lookup rebuilds it
+        mutable size_t duplicates{ 0 };           // records whose account an earlier one already has
+    };
+
+    array<Shard, shardCount> shards;
+    CowVector<uint64_t> order; // display order; shard << 32 | position in that shard
+    mutex orderMutex;          // concurrent inserts append to order one at a time
+    atomic<unsigned long> revisionCount{ 0 };
+    AccountNumberAllocator accountNumbers; // seeded in loadFromFile, never reuses a number
+
+    // Pre-formatted table rows keyed by shard position, built one page at a
+    // time. The row number is added when printing, so sorting keeps them;
+    // the cache is dropped whenever it reaches rowCacheLimit rows.
+    mutable unordered_map<uint64_t, string> rowCache;
+    mutable mutex rowCacheMutex;
+    static const size_t rowCacheLimit = 4096;
+    void markModified();                 // bumps the revision
+    void markRecordEdited(uint64_t ref); // bumps the revision, drops that record's cached row
+    static string formatHeader();
+    const string& formattedRow(uint64_t ref) const; // caller holds rowCacheMutex
+
+    static size_t shardOf(int acct);
+    static uint64_t makeRef(size_t shard, size_t pos) { return (static_cast<uint64_t>(shard) << 32) | pos; }
+    const Customer& record(uint64_t ref) const { return shards[ref >> 32].records[ref & 0xFFFFFFFFu]; }
+    void ensureIndexed(const Shard& s) const;
+    uint64_t append(size_t shard, const Customer& c); // caller holds the shard lock or owns the table
+    void copyFrom(const AllCustomers& other);
+    void moveFrom(AllCustomers& other);
 
     // Validation helpers
     static bool isDigits(const string& s);
-    bool accountExists(int acct) const;
     // Internal helper for interactive input
     Customer promptForCustomer(int suggestedAcct = 0) const;
 };
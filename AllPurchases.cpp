@@ -1,4 +1,5 @@
 #include "AllPurchases.h"
+#include "Filters.h"
 #include <sstream>
 #include <limits>
 #include <algorithm>
@@ -11,11 +12,31 @@ AllPurchases::AllPurchases() = default;
 AllPurchases::AllPurchases(const AllPurchases& other)
 {
     purchases = other.purchases;
+    revisionCount = other.revisionCount;
 }
 
 AllPurchases& AllPurchases::operator=(const AllPurchases& other)
 {
-    if (this != &other) purchases = other.purchases;
+    if (this != &other) {
+        purchases = other.purchases;
+        revisionCount = nextRevision(); // never mistaken for what this table held before
+    }
+    return *this;
+}
+
+AllPurchases::AllPurchases(AllPurchases&& other) noexcept
+    : purchases(std::move(other.purchases)), revisionCount(other.revisionCount)
+{
+    other.revisionCount = 0; // other is now empty
+}
+
+AllPurchases& AllPurchases::operator=(AllPurchases&& other) noexcept
+{
+    if (this != &other) {
+        purchases = std::move(other.purchases);
+        revisionCount = nextRevision();
+        other.revisionCount = 0;
+    }
     return *this;
 }
 
@@ -27,6 +48,7 @@ bool AllPurchases::loadFromFile(const string& filename)
     ifstream in(filename);
     if (!in) return false;
     purchases.clear();
+    revisionCount = nextRevision();
     string line;
     while (getline(in, line)) {
         if (line.empty()) continue;
@@ -52,15 +74,17 @@ bool AllPurchases::saveToFile(const string& filename) const
 {
     ofstream out(filename);
     if (!out) return false;
+    out << setprecision(15); // default of 6 digits would round 12345.67 to 12345.7
     for (const auto& p : purchases) {
         out << p.accountNumber << ','
             << p.item << ","
             << p.brand << ","
             << p.color << ","
             << p.date << ","
-            << p.amount << endl;
+            << p.amount << '\n';
     }
-    return true;
+    out.flush();
+    return out.good(); // false on a full disk or other write error
 }
 
 // Print 
@@ -68,40 +92,43 @@ void AllPurchases::printCustomerPurchases(int acct) const
 {
     double total = 0.0;
     bool any = false;
-    cout << left << setw(5) << "#"
+    // build the whole table first and hand it to cout in one write
+    ostringstream buf;
+    buf << left << setw(5) << "#"
         << setw(18) << "Model"
         << setw(15) << "Brand"
         << setw(12) << "Color"
         << setw(12) << "Date"
-        << right << setw(10) << "Amount" << endl;
-    cout << string(72, '-') << endl;
+        << right << setw(10) << "Amount" << '\n';
+    buf << string(72, '-') << '\n';
+    buf << fixed << setprecision(2);
     size_t idx = 1;
     for (const auto& p : purchases) {
         if (p.accountNumber == acct) {
             any = true;
-            cout << left << setw(5) << idx++
+            buf << left << setw(5) << idx++
                 << setw(18) << p.item
                 << setw(15) << p.brand
                 << setw(12) << p.color
                 << setw(12) << p.date
-                << right << setw(10) << fixed << setprecision(2) << p.amount << endl;
+                << right << setw(10) << p.amount << '\n';
             total += p.amount;
         }
     }
     if (!any) {
-        cout << "No purchases found for account " << acct << endl;
+        buf << "No purchases found for account " << acct << '\n';
     }
     else {
-        cout << string(72, '-') << endl;
-        cout << setw(62) << "Total:" << right << setw(12) << fixed << setprecision(2) << total << endl;
+        buf << string(72, '-') << '\n';
+        buf << setw(62) << "Total:" << right << setw(12) << total << '\n';
     }
+    const string text = buf.str();
+    cout.write(text.data(), static_cast<streamsize>(text.size()));
 }
 
 double AllPurchases::totalCustomerSpend(int acct) const
 {
-    double total = 0.0;
-    for (const auto& p : purchases) if (p.accountNumber == acct) total += p.amount;
-    return total;
+    return filter::sum(purchases, filter::field<&Purchase::accountNumber> == acct, &Purchase::amount);
 }
 
 // Add / Delete 
@@ -140,6 +167,7 @@ void AllPurchases::addPurchaseInteractive()
         break;
     }
     purchases.push_back(p);
+    revisionCount = nextRevision();
     cout << "Purchase added." << endl;
 }
 
@@ -153,8 +181,8 @@ void AllPurchases::addMultiplePurchasesRecursive(int remaining)
 
 void AllPurchases::deletePurchasesForCustomer(int acct)
 {
-    purchases.erase(std::remove_if(purchases.begin(), purchases.end(),
-        [acct](const Purchase& p) { return p.accountNumber == acct; }), purchases.end());
+    purchases.removeIf([acct](const Purchase& p) { return p.accountNumber == acct; });
+    revisionCount = nextRevision();
 }
 
 //  Utilities
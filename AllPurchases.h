@@ -6,6 +6,8 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include "CowVector.h"
+#include "Revision.h"
 
 using namespace std;
 
@@ -28,8 +30,10 @@ struct Purchase {
 class AllPurchases {
 public:
     AllPurchases();
-    AllPurchases(const AllPurchases& other);
+    AllPurchases(const AllPurchases& other); // O(1): records are shared until written
     AllPurchases& operator=(const AllPurchases& other);
+    AllPurchases(AllPurchases&& other) noexcept;
+    AllPurchases& operator=(AllPurchases&& other) noexcept;
     ~AllPurchases();
 
     // File I/O
@@ -48,9 +52,12 @@ public:
     // Utilities
     size_t size() const { return purchases.size(); }
     const Purchase& get(size_t index) const { return purchases[index]; }
+    const CowVector<Purchase>& records() const { return purchases; } // read-only, for scans
+    unsigned long revision() const { return revisionCount; } // equal revisions mean equal records, see Revision.h
 
 private:
-    vector<Purchase> purchases;
+    CowVector<Purchase> purchases; // copy-on-write chunks, see CowVector.h
+    unsigned long revisionCount{ 0 };
     static bool validAmountString(const string& s);
 };
 
@@ -0,0 +1,212 @@
+#include "BackgroundSaver.h"
+#include <filesystem>
+#include <cstdio>
+
+using namespace std;
+
+// --------------------- Constructors / Destructor -----------------------
+BackgroundSaver::BackgroundSaver(const string& custFile, const string& purchFile, const string& cubeFileName)
+    : customerFile(custFile), purchaseFile(purchFile), cubeFile(cubeFileName),
+    lastAutosave(chrono::steady_clock::now()),
+    worker(&BackgroundSaver::workerLoop, this)
+{
+}
+
+BackgroundSaver::~BackgroundSaver()
+{
+    {
+        lock_guard<mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    worker.join(); // worker drains the queue before it exits
+}
+
+// --------------------- Saving -----------------------
+void BackgroundSaver::saveAsync(const AllCustomers& customers, const AllPurchases& purchases, const RevenueCube* cube)
+{
+    // copy on the caller's thread; the worker only ever sees the copy. The
+    // tables are O(1) to copy; the cube is a full copy, proportional to its
+    // cells and accounts rather than to the purchases.
+    unique_ptr<Snapshot> snap(new Snapshot{ customers, purchases, nullptr });
+    if (cube && !cubeFile.empty()) snap->cube.reset(new RevenueCube(*cube));
+    {
+        lock_guard<mutex> lock(mtx);
+        queued = std::move(snap); // an older queued snapshot is superseded
+    }
+    cv.notify_all();
+}
+
+bool BackgroundSaver::saveNow(const AllCustomers& customers, const AllPurchases& purchases, const RevenueCube* cube)
+{
+    saveAsync(customers, purchases, cube);
+    return waitForIdle();
+}
+
+bool BackgroundSaver::waitForIdle()
+{
+    unique_lock<mutex> lock(mtx);
+    cv.wait(lock, [this] { return !queued && !writing; });
+    return lastOk;
+}
+
+void BackgroundSaver::workerLoop()
+{
+    unique_lock<mutex> lock(mtx);
+    while (true) {
+        if (!queued && !stopping) {
+            if (autosaveSeconds > 0 && watchedMutex) {
+                if (cv.wait_until(lock, lastAutosave + chrono::seconds(autosaveSeconds)) == cv_status::timeout) {
+                    lock.unlock();
+                    autosaveIfChanged();
+                    lock.lock();
+                }
+            }
+            else {
+                cv.wait(lock);
+            }
+            continue; // re-check queued / stopping
+        }
+        if (!queued) break; // stopping and nothing left to write
+
+        unique_ptr<Snapshot> snap = std::move(queued);
+        writing = true;
+        lock.unlock();
+
+        string message;
+        bool ok = writeSnapshot(*snap, message);
+
+        lock.lock();
+        writing = false;
+        lastOk = ok;
+        lastMessage = message;
+        if (ok) {
+            savedCustomerRev = snap->customers.revision();
+            savedPurchaseRev = snap->purchases.revision();
+        }
+        cv.notify_all(); // wake waitForIdle()
+    }
+}
+
+bool BackgroundSaver::writeSnapshot(const Snapshot& snap, string& message) const
+{
+    const string custTmp = customerFile + ".tmp";
+    const string purchTmp = purchaseFile + ".tmp";
+    const string cubeTmp = cubeFile + ".tmp";
+
+    // write both temp files first so the renames happen back to back
+    if (!snap.customers.saveToFile(custTmp) || !snap.purchases.saveToFile(purchTmp)) {
+        std::remove(custTmp.c_str());
+        std::remove(purchTmp.c_str());
+        message = "Save failed: could not write temporary files.";
+        return false;
+    }
+    // each rename is atomic, but the pair is not
+    if (!replaceFile(custTmp, customerFile)) {
+        std::remove(custTmp.c_str());
+        std::remove(purchTmp.c_str());
+        message = "Save failed: could not replace data files; both files are unchanged.";
+        return false;
+    }
+    if (!replaceFile(purchTmp, purchaseFile)) {
+        std::remove(purchTmp.c_str());
+        message = "Save incomplete: " + customerFile + " was updated but " + purchaseFile
+            + " was not, so the two files are from different saves. Save again.";
+        return false;
+    }
+    message = "Saved " + to_string(snap.customers.size()) + " customers and "
+        + to_string(snap.purchases.size()) + " purchases.";
+
+    // the cube is only a cache of the data files; if it can't be replaced
+    // the old one fails its checksums on the next start and is rebuilt
+    if (snap.cube && (!snap.cube->saveToFile(cubeTmp) || !replaceFile(cubeTmp, cubeFile))) {
+        std::remove(cubeTmp.c_str());
+        message += " " + cubeFile + " was not updated and will be rebuilt on the next start.";
+    }
+    return true;
+}
+
+bool BackgroundSaver::replaceFile(const string& tmpName, const string& finalName)
+{
+    error_code ec;
+    filesystem::rename(tmpName, finalName, ec);
+    return !ec;
+}
+
+// --------------------- Autosave -----------------------
+void BackgroundSaver::setAutosaveInterval(int seconds)
+{
+    {
+        lock_guard<mutex> lock(mtx);
+        autosaveSeconds = seconds < 0 ? 0 : seconds;
+        lastAutosave = chrono::steady_clock::now();
+    }
+    cv.notify_all(); // worker recomputes its deadline
+}
+
+int BackgroundSaver::autosaveInterval() const
+{
+    lock_guard<mutex> lock(mtx);
+    return autosaveSeconds;
+}
+
+void BackgroundSaver::watch(const AllCustomers& customers, const AllPurchases& purchases, mutex& dataMutex,
+    const RevenueCube* cube)
+{
+    {
+        lock_guard<mutex> lock(mtx);
+        watchedCustomers = &customers;
+        watchedPurchases = &purchases;
+        watchedCube = cube;
+        watchedMutex = &dataMutex;
+    }
+    cv.notify_all();
+}
+
+void BackgroundSaver::autosaveIfChanged()
+{
+    // lock order is always dataMutex before mtx; try_lock so a running menu
+    // action (or an exit waiting on this thread) never blocks the worker
+    unique_lock<mutex> data(*watchedMutex, try_to_lock);
+    if (!data.owns_lock()) {
+        lock_guard<mutex> lock(mtx);
+        lastAutosave = chrono::steady_clock::now() - chrono::seconds(autosaveSeconds) + chrono::seconds(1); // retry in 1s
+        return;
+    }
+    {
+        lock_guard<mutex> lock(mtx);
+        lastAutosave = chrono::steady_clock::now();
+    }
+    // the menu is held up only for the copies; the cube changes only with the tables
+    if (hasUnsavedChanges(*watchedCustomers, *watchedPurchases)) {
+        saveAsync(*watchedCustomers, *watchedPurchases, watchedCube);
+    }
+}
+
+// --------------------- Status -----------------------
+void BackgroundSaver::markClean(const AllCustomers& customers, const AllPurchases& purchases)
+{
+    lock_guard<mutex> lock(mtx);
+    savedCustomerRev = customers.revision();
+    savedPurchaseRev = purchases.revision();
+}
+
+bool BackgroundSaver::hasUnsavedChanges(const AllCustomers& customers, const AllPurchases& purchases) const
+{
+    lock_guard<mutex> lock(mtx);
+    return customers.revision() != savedCustomerRev || purchases.revision() != savedPurchaseRev;
+}
+
+bool BackgroundSaver::isSaving() const
+{
+    lock_guard<mutex> lock(mtx);
+    return writing || queued;
+}
+
+string BackgroundSaver::status() const
+{
+    lock_guard<mutex> lock(mtx);
+    string s = (writing || queued) ? "Saving in background..." : lastMessage;
+    s += autosaveSeconds > 0 ? " (autosave every " + to_string(autosaveSeconds) + "s)" : " (autosave off)";
+    return s;
+}
@@ -0,0 +1,88 @@
+#ifndef BACKGROUNDSAVER_H
+#define BACKGROUNDSAVER_H
+
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "AllCustomers.h"
+#include "AllPurchases.h"
+#include "RevenueCube.h"
+
+using namespace std;
+
+// Writes customers, purchases and optionally the revenue cube to disk on a
+// worker thread.
+// saveAsync() copies both tables on the calling thread (O(1), the records
+// are copy-on-write), so later edits in the menu never touch the data being
+// written. Each file is written to a ".tmp" file first and renamed over the
+// original, so a file is either the old or the new version, never
+// half-written. The cube is copied with the tables and renamed last; its
+// checksums tell the next start whether it matches the data files.
+class BackgroundSaver {
+public:
+    BackgroundSaver(const string& custFile, const string& purchFile, const string& cubeFile = string());
+    BackgroundSaver(const BackgroundSaver&) = delete;
+    BackgroundSaver& operator=(const BackgroundSaver&) = delete;
+    ~BackgroundSaver(); // finishes any queued save before returning
+
+    // Saving
+    // cube may be null; it is only written when a cube file was given
+    void saveAsync(const AllCustomers& customers, const AllPurchases& purchases, const RevenueCube* cube = nullptr);
+    bool saveNow(const AllCustomers& customers, const AllPurchases& purchases, const RevenueCube* cube = nullptr); // blocking
+    bool waitForIdle(); // returns whether the last save succeeded
+
+    // Autosave (0 = off). watch() gives the worker the live tables and the
+    // mutex the menu holds while it changes them; every interval the worker
+    // takes that mutex (skipping the round if an action is running), and
+    // queues a save if anything changed.
+    void watch(const AllCustomers& customers, const AllPurchases& purchases, mutex& dataMutex,
+        const RevenueCube* cube = nullptr);
+    void setAutosaveInterval(int seconds);
+    int autosaveInterval() const;
+
+    // Status
+    void markClean(const AllCustomers& customers, const AllPurchases& purchases); // data matches the files
+    bool hasUnsavedChanges(const AllCustomers& customers, const AllPurchases& purchases) const;
+    bool isSaving() const;
+    string status() const;
+
+private:
+    struct Snapshot {
+        AllCustomers customers;
+        AllPurchases purchases;
+        unique_ptr<RevenueCube> cube; // null when the cube isn't saved
+    };
+
+    string customerFile;
+    string purchaseFile;
+    string cubeFile; // empty = don't save the cube
+
+    mutable mutex mtx;
+    condition_variable cv;
+    unique_ptr<Snapshot> queued; // newest snapshot waiting to be written
+    bool writing{ false };
+    bool stopping{ false };
+    bool lastOk{ true };
+    string lastMessage{ "No save yet." };
+    unsigned long savedCustomerRev{ 0 };
+    unsigned long savedPurchaseRev{ 0 };
+
+    int autosaveSeconds{ 0 };
+    chrono::steady_clock::time_point lastAutosave;
+    const AllCustomers* watchedCustomers{ nullptr };
+    const AllPurchases* watchedPurchases{ nullptr };
+    const RevenueCube* watchedCube{ nullptr };
+    mutex* watchedMutex{ nullptr };
+
+    thread worker; // declared last so everything above exists when it starts
+
+    void workerLoop();
+    void autosaveIfChanged(); // called by the worker without mtx held
+    bool writeSnapshot(const Snapshot& snap, string& message) const;
+    static bool replaceFile(const string& tmpName, const string& finalName);
+};
+
+#endif // BACKGROUNDSAVER_H
@@ -0,0 +1,257 @@
+#ifndef COWVECTOR_H
+#define COWVECTOR_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+// Vector stored as chunks of up to ChunkSize records that are shared
+// between copies. Copying is O(1): both copies point at the same chunk
+// table. The first write through either copy clones the table (one pointer
+// and one offset per chunk) and then only the chunks that actually change,
+// so a snapshot of a big table costs almost nothing and an edit afterwards
+// duplicates at most ChunkSize records per touched chunk.
+//
+// Chunks may be partly full after erase() or removeIf(); a prefix offset
+// per chunk maps an index to its chunk. While no chunk has shrunk (the
+// common case: load, then append) the lookup is a plain division.
+//
+// Reading a copy on another thread while the original is edited is safe;
+// two threads must not edit the same CowVector.
+template <typename T, size_t ChunkSize = 1024>
+class CowVector {
+    using Chunk = vector<T>;
+    struct Table {
+        vector<shared_ptr<Chunk>> chunks; // never empty chunks
+        vector<size_t> starts;            // index of the first record of each chunk
+        size_t count{ 0 };
+        bool uniform{ true };             // every chunk but the last is full
+    };
+
+public:
+    class const_iterator {
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator(const Table* t, size_t c, size_t off, size_t i)
+            : table(t), chunk(c), offset(off), index(i) {}
+        reference operator*() const { return (*table->chunks[chunk])[offset]; }
+        pointer operator->() const { return &**this; }
+        const_iterator& operator++()
+        {
+            ++index;
+            if (++offset == table->chunks[chunk]->size()) {
+                ++chunk;
+                offset = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+        bool operator==(const const_iterator& o) const { return index == o.index; }
+        bool operator!=(const const_iterator& o) const { return index != o.index; }
+
+    private:
+        const Table* table;
+        size_t chunk;
+        size_t offset;
+        size_t index;
+    };
+
+    CowVector() : table(emptyTable()) {}
+    CowVector(const CowVector& other) = default; // shares chunks
+    CowVector& operator=(const CowVector& other) = default;
+    CowVector(CowVector&& other) noexcept : table(std::move(other.table)) { other.table = emptyTable(); }
+    CowVector& operator=(CowVector&& other) noexcept
+    {
+        if (this != &other) {
+            table = std::move(other.table);
+            other.table = emptyTable();
+        }
+        return *this;
+    }
+
+    // Read access never copies anything
+    size_t size() const { return table->count; }
+    bool empty() const { return table->count == 0; }
+    const T& operator[](size_t i) const
+    {
+        size_t c = chunkOf(*table, i);
+        return (*table->chunks[c])[i - table->starts[c]];
+    }
+    const T& at(size_t i) const
+    {
+        if (i >= table->count) throw out_of_range("CowVector::at");
+        return (*this)[i];
+    }
+    const_iterator begin() const { return const_iterator(table.get(), 0, 0, 0); }
+    const_iterator end() const { return const_iterator(table.get(), table->chunks.size(), 0, table->count); }
+
+    // Calls fn(data, length, firstIndex) once per chunk; lets scans run over
+    // plain arrays instead of going through the chunk table for every record
+    template <typename Fn>
+    void forEachChunk(Fn fn) const
+    {
+        for (size_t c = 0; c < table->chunks.size(); ++c) {
+            const Chunk& chunk = *table->chunks[c];
+            fn(chunk.data(), chunk.size(), table->starts[c]);
+        }
+    }
+
+    // Write access copies the touched chunk first if it is shared
+    T& mutableAt(size_t i)
+    {
+        if (i >= table->count) throw out_of_range("CowVector::mutableAt");
+        size_t c = chunkOf(*table, i);
+        return writableChunk(c)[i - table->starts[c]];
+    }
+
+    void push_back(const T& value)
+    {
+        Table& t = writableTable();
+        if (t.chunks.empty() || t.chunks.back()->size() == ChunkSize) {
+            t.starts.push_back(t.count);
+            t.chunks.push_back(make_shared<Chunk>());
+            t.chunks.back()->reserve(ChunkSize);
+        }
+        else {
+            writableChunk(t.chunks.size() - 1);
+        }
+        t.chunks.back()->push_back(value);
+        ++t.count;
+    }
+
+    // Only the chunk holding i is copied; later chunks just have their offset moved
+    void erase(size_t i)
+    {
+        if (i >= table->count) return;
+        Table& t = writableTable();
+        size_t c = chunkOf(t, i);
+        Chunk& chunk = writableChunk(c);
+        chunk.erase(chunk.begin() + static_cast<ptrdiff_t>(i - t.starts[c]));
+        if (chunk.empty()) {
+            t.chunks.erase(t.chunks.begin() + static_cast<ptrdiff_t>(c));
+            t.starts.erase(t.starts.begin() + static_cast<ptrdiff_t>(c));
+        }
+        else {
+            ++c;
+        }
+        for (size_t k = c; k < t.starts.size(); ++k) --t.starts[k];
+        --t.count;
+        if (c < t.chunks.size()) t.uniform = false; // a chunk before the last is now short
+    }
+
+    void clear() { table = emptyTable(); }
+
+    // Chunks without a match are kept as is (still shared); only chunks
+    // that lose records are rebuilt
+    template <typename Pred>
+    void removeIf(Pred pred)
+    {
+        const Table& old = *table;
+        vector<shared_ptr<Chunk>> chunks;
+        chunks.reserve(old.chunks.size());
+        bool changed = false;
+        for (const auto& chunk : old.chunks) {
+            if (std::none_of(chunk->begin(), chunk->end(), pred)) {
+                chunks.push_back(chunk);
+                continue;
+            }
+            changed = true;
+            auto kept = make_shared<Chunk>();
+            for (const T& v : *chunk) if (!pred(v)) kept->push_back(v);
+            if (!kept->empty()) chunks.push_back(std::move(kept));
+        }
+        if (!changed) return;
+        setChunks(std::move(chunks));
+    }
+
+    template <typename Compare>
+    void sort(Compare comp)
+    {
+        vector<T> all(begin(), end());
+        std::sort(all.begin(), all.end(), comp);
+        assign(std::move(all));
+    }
+
+private:
+    shared_ptr<Table> table;
+
+    // One shared empty table so default-constructed and moved-from vectors don't allocate
+    static const shared_ptr<Table>& emptyTable()
+    {
+        static const shared_ptr<Table> empty = make_shared<Table>();
+        return empty;
+    }
+
+    static size_t chunkOf(const Table& t, size_t i)
+    {
+        if (t.uniform) return i / ChunkSize;
+        return static_cast<size_t>(std::upper_bound(t.starts.begin(), t.starts.end(), i) - t.starts.begin()) - 1;
+    }
+
+    // use_count() == 1 means no other copy can reach it; the fence pairs with
+    // the release in the other owner's shared_ptr destructor
+    template <typename P>
+    static bool isUnique(const shared_ptr<P>& p)
+    {
+        if (p.use_count() != 1) return false;
+        atomic_thread_fence(memory_order_acquire);
+        return true;
+    }
+
+    Table& writableTable()
+    {
+        if (!isUnique(table)) table = make_shared<Table>(*table); // copies chunk pointers only
+        return *table;
+    }
+
+    Chunk& writableChunk(size_t c)
+    {
+        Table& t = writableTable();
+        if (!isUnique(t.chunks[c])) {
+            auto copy = make_shared<Chunk>();
+            copy->reserve(ChunkSize); // room to append without reallocating
+            copy->assign(t.chunks[c]->begin(), t.chunks[c]->end());
+            t.chunks[c] = std::move(copy);
+        }
+        return *t.chunks[c];
+    }
+
+    void setChunks(vector<shared_ptr<Chunk>>&& chunks)
+    {
+        auto fresh = make_shared<Table>();
+        fresh->chunks = std::move(chunks);
+        fresh->starts.reserve(fresh->chunks.size());
+        for (size_t c = 0; c < fresh->chunks.size(); ++c) {
+            fresh->starts.push_back(fresh->count);
+            fresh->count += fresh->chunks[c]->size();
+            if (c + 1 < fresh->chunks.size() && fresh->chunks[c]->size() != ChunkSize) fresh->uniform = false;
+        }
+        table = std::move(fresh);
+    }
+
+    void assign(vector<T>&& values)
+    {
+        vector<shared_ptr<Chunk>> chunks;
+        for (size_t i = 0; i < values.size(); i += ChunkSize) {
+            size_t end = std::min(values.size(), i + ChunkSize);
+            auto chunk = make_shared<Chunk>();
+            chunk->reserve(ChunkSize);
+            chunk->assign(make_move_iterator(values.begin() + static_cast<ptrdiff_t>(i)),
+                make_move_iterator(values.begin() + static_cast<ptrdiff_t>(end)));
+            chunks.push_back(std::move(chunk));
+        }
+        setChunks(std::move(chunks));
+    }
+};
+
+#endif // COWVECTOR_H
@@ -9,27 +9,128 @@ AllCustomers::AllCustomers() = default;
 
 AllCustomers::AllCustomers(const AllCustomers& other)
 {
-    // deep copy of vector
-    customers = other.customers;
+    copyFrom(other);
 }
 
 AllCustomers& AllCustomers::operator=(const AllCustomers& other)
 {
     if (this != &other) {
-        customers = other.customers; // vector does deep copy of contained strings
+        copyFrom(other);
+        revisionCount = nextRevision(); // never mistaken for what this table held before
+    }
+    return *this;
+}
+
+AllCustomers::AllCustomers(AllCustomers&& other) noexcept
+{
+    moveFrom(other);
+}
+
+AllCustomers& AllCustomers::operator=(AllCustomers&& other) noexcept
+{
+    if (this != &other) {
+        moveFrom(other);
+        revisionCount = nextRevision();
     }
     return *this;
 }
 
 AllCustomers::~AllCustomers() = default;
 
+void AllCustomers::copyFrom(const AllCustomers& other)
+{
+    for (size_t i = 0; i < shardCount; ++i) {
+        // shares the record chunks; whichever side edits first copies the chunk it touches
+        shards[i].records = other.shards[i].records;
+        // a copy is usually a snapshot that is only saved, so its index is built on demand
+        shards[i].index.clear();
+        shards[i].indexed = false;
+        shards[i].duplicates = 0;
+    }
+    order = other.order;
+    revisionCount = other.revisionCount.load();
+    accountNumbers = other.accountNumbers;
+    lock_guard<mutex> lock(rowCacheMutex);
+    rowCache.clear();
+}
+
+void AllCustomers::moveFrom(AllCustomers& other)
+{
+    for (size_t i = 0; i < shardCount; ++i) {
+        Shard& mine = shards[i];
+        Shard& theirs = other.shards[i];
+        mine.records = std::move(theirs.records);
+        mine.index = std::move(theirs.index);
+        mine.indexed = theirs.indexed;
+        mine.duplicates = theirs.duplicates;
+        theirs.index.clear();
+        theirs.indexed = true;
+        theirs.duplicates = 0;
+    }
+    order = std::move(other.order);
+    revisionCount = other.revisionCount.load();
+    accountNumbers = other.accountNumbers;
+    other.revisionCount = 0; // other is now empty
+    lock_guard<mutex> lock(rowCacheMutex);
+    rowCache.clear();
+}
+
+// --------------------- Shards -----------------------
+size_t AllCustomers::shardOf(int acct)
+{
+    // Fibonacci hashing spreads consecutive account numbers over all shards
+    uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(acct)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(h >> (64 - shardBits));
+}
+
+void AllCustomers::ensureIndexed(const Shard& s) const
+{
+    {
+        shared_lock<shared_mutex> lock(s.lock);
+        if (s.indexed) return;
+    }
+    unique_lock<shared_mutex> lock(s.lock);
+    if (s.indexed) return; // another thread got here first
+    s.index.clear();
+    s.index.reserve(s.records.size());
+    s.duplicates = 0;
+    size_t pos = 0;
+    for (const auto& c : s.records) {
+        if (!s.index.emplace(c.accountNumber, pos).second) ++s.duplicates;
+        ++pos;
+    }
+    s.indexed = true;
+}
+
+uint64_t AllCustomers::append(size_t shard, const Customer& c)
+{
+    Shard& s = shards[shard];
+    size_t pos = s.records.size();
+    // the file may repeat an account; the first record keeps the index entry
+    if (!s.index.emplace(c.accountNumber, pos).second) ++s.duplicates;
+    s.records.push_back(c);
+    return makeRef(shard, pos);
+}
+
 // --------------------- File I/O -----------------------
 bool AllCustomers::loadFromFile(const string& filename)
 {
     ifstream in(filename);
     if (!in) return false;
 
-    customers.clear();
+    for (Shard& s : shards) {
+        s.records.clear();
+        s.index.clear();
+        s.indexed = true;
+        s.duplicates = 0;
+    }
+    order.clear();
+    markModified();
+    {
+        lock_guard<mutex> lock(rowCacheMutex);
+        rowCache.clear();
+    }
+    accountNumbers.reset(1000);
     string line;
     while (std::getline(in, line)) {
         if (line.empty()) continue;
@@ -38,6 +139,7 @@ bool AllCustomers::loadFromFile(const string& filename)
         string token;
         vector<string> fields;
         while (std::getline(ss, token, ',')) fields.push_back(token);
+        if (line.back() == ',') fields.push_back(string()); // getline drops a trailing empty field (blank phone)
         if (fields.size() < 8) continue; // skip malformed
         Customer c;
         c.firstName = fields[0];
@@ -48,7 +150,8 @@ bool AllCustomers::loadFromFile(const string& filename)
         c.state = fields[5];
         c.zip = fields[6];
         c.phone = fields[7];
-        customers.push_back(c);
+        accountNumbers.observe(c.accountNumber);
+        order.push_back(append(shardOf(c.accountNumber), c));
     }
     return true;
 }
@@ -58,7 +161,8 @@ bool AllCustomers::saveToFile(const string& filename) const
     ofstream out(filename);
     if (!out) return false;
     // CSV
-    for (const auto& c : customers) {
+    for (uint64_t ref : order) {
+        const Customer& c = record(ref);
         out << c.firstName << ','
             << c.lastName << ','
             << c.accountNumber << ','
@@ -68,53 +172,119 @@ bool AllCustomers::saveToFile(const string& filename) const
             << c.zip << ','
             << c.phone << '\n';
     }
-    return true;
+    out.flush();
+    return out.good(); // false on a full disk or other write error
 }
 
 // --------------------- Printing & UI helpers -----------------------
-void AllCustomers::printAllCustomers() const
+namespace {
+    // Same layout as `left << setw(width) << text`, without going through the stream
+    void appendPadded(string& buf, const string& text, size_t width)
+    {
+        buf += text;
+        if (text.size() < width) buf.append(width - text.size(), ' ');
+    }
+
+    // Everything after the row number
+    string formatRow(const Customer& c)
+    {
+        string row;
+        row.reserve(92);
+        appendPadded(row, c.lastName, 15);
+        appendPadded(row, c.firstName, 15);
+        appendPadded(row, std::to_string(c.accountNumber), 10);
+        appendPadded(row, c.city, 25);
+        appendPadded(row, c.state, 8);
+        appendPadded(row, c.phone, 12);
+        row += '\n';
+        return row;
+    }
+}
+
+string AllCustomers::formatHeader()
+{
+    string header;
+    appendPadded(header, "#", 4);
+    appendPadded(header, "Last Name", 15);
+    appendPadded(header, "First Name", 15);
+    appendPadded(header, "Account", 10);
+    appendPadded(header, "City", 25);
+    appendPadded(header, "State", 8);
+    appendPadded(header, "Phone", 12);
+    header += '\n';
+    header.append(79, '-');
+    header += '\n';
+    return header;
+}
+
+const string& AllCustomers::formattedRow(uint64_t ref) const
 {
-    if (customers.empty()) {
-        cout << "No customers to display.\n";
+    auto it = rowCache.find(ref);
+    if (it != rowCache.end()) return it->second;
+    if (rowCache.size() >= rowCacheLimit) rowCache.clear(); // paging through a huge table keeps memory bounded
+    return rowCache.emplace(ref, formatRow(record(ref))).first->second;
+}
+
+void AllCustomers::markModified()
+{
+    revisionCount = nextRevision();
+}
+
+void AllCustomers::markRecordEdited(uint64_t ref)
+{
+    revisionCount = nextRevision();
+    lock_guard<mutex> lock(rowCacheMutex);
+    rowCache.erase(ref);
+}
+
+size_t AllCustomers::pageCount(size_t pageSize) const
+{
+    if (order.empty()) return 0;
+    if (pageSize == 0) return 1;
+    return (order.size() + pageSize - 1) / pageSize;
+}
+
+void AllCustomers::printCustomersPage(size_t page, size_t pageSize, std::ostream& out) const
+{
+    if (order.empty()) {
+        out << "No customers to display.\n";
         return;
     }
-    cout << left << setw(4) << "#"
-        << setw(15) << "Last Name"
-        << setw(15) << "First Name"
-        << setw(10) << "Account"
-        << setw(25) << "City"
-        << setw(8) << "State"
-        << setw(12) << "Phone" << '\n';
-    cout << std::string(79, '-') << '\n';
-    size_t idx = 1;
-    for (const auto& c : customers) {
-        cout << setw(4) << idx++
-            << setw(15) << c.lastName
-            << setw(15) << c.firstName
-            << setw(10) << c.accountNumber
-            << setw(25) << c.city
-            << setw(8) << c.state
-            << setw(12) << c.phone << '\n';
+    if (pageSize == 0) pageSize = order.size();
+    size_t pages = pageCount(pageSize);
+    if (page >= pages) page = pages - 1;
+
+    size_t first = page * pageSize;
+    size_t last = std::min(first + pageSize, order.size());
+    string buf = formatHeader();
+    {
+        lock_guard<mutex> lock(rowCacheMutex);
+        for (size_t i = first; i < last; ++i) {
+            appendPadded(buf, std::to_string(i + 1), 4);
+            buf += formattedRow(order[i]);
+        }
     }
+    buf += "Page " + std::to_string(page + 1) + " of " + std::to_string(pages)
+        + " (" + std::to_string(order.size()) + " customers)\n";
+    out.write(buf.data(), static_cast<streamsize>(buf.size())); // one write per page
 }
 
 void AllCustomers::printCustomerByIndex(size_t index) const
 {
-    if (index >= customers.size()) {
+    if (index >= order.size()) {
         std::cout << "Invalid index.\n";
         return;
     }
-    printCustomerByAccount(customers[index].accountNumber);
+    printCustomerByAccount(at(index).accountNumber);
 }
 
 void AllCustomers::printCustomerByAccount(int acct, std::ostream& out) const
 {
-    int idx = findIndexByAccount(acct);
-    if (idx < 0) {
+    Customer c;
+    if (!findCustomer(acct, c)) {
         out << "Customer not found (acct " << acct << ").\n";
         return;
     }
-    const Customer& c = customers[idx];
     out << "Account #: " << c.accountNumber << '\n';
     out << "Name      : " << c.firstName << " " << c.lastName << '\n';
     out << "Address   : " << c.street << ", " << c.city << ", " << c.state << " " << c.zip << '\n';
@@ -122,37 +292,82 @@ void AllCustomers::printCustomerByAccount(int acct, std::ostream& out) const
 }
 
 // --------------------- Sorting -----------------------
+// Only the display order moves; records stay where they are in their shards
 void AllCustomers::sortAscending()
 {
-    std::sort(customers.begin(), customers.end(),
-        [](const Customer& a, const Customer& b) {
+    order.sort(
+        [this](uint64_t x, uint64_t y) {
+            const Customer& a = record(x);
+            const Customer& b = record(y);
             if (a.lastName != b.lastName) return a.lastName < b.lastName;
             return a.firstName < b.firstName;
         });
+    markModified();
 }
 
 void AllCustomers::sortDescending()
 {
-    std::sort(customers.begin(), customers.end(),
-        [](const Customer& a, const Customer& b) {
+    order.sort(
+        [this](uint64_t x, uint64_t y) {
+            const Customer& a = record(x);
+            const Customer& b = record(y);
             if (a.lastName != b.lastName) return a.lastName > b.lastName;
             return a.firstName > b.firstName;
         });
+    markModified();
 }
 
 // --------------------- Search -----------------------
 int AllCustomers::findIndexByAccount(int acct) const
 {
-    for (size_t i = 0; i < customers.size(); ++i)
-        if (customers[i].accountNumber == acct) return static_cast<int>(i);
-    return -1;
+    size_t shard = shardOf(acct);
+    const Shard& s = shards[shard];
+    ensureIndexed(s);
+    uint64_t ref;
+    {
+        shared_lock<shared_mutex> lock(s.lock);
+        auto it = s.index.find(acct);
+        if (it == s.index.end()) return -1;
+        ref = makeRef(shard, it->second);
+    }
+    // the shard knows where the record is, not where it is shown
+    int found = -1;
+    order.forEachChunk([&](const uint64_t* data, size_t len, size_t base) {
+        for (size_t i = 0; i < len && found < 0; ++i) {
+            if (data[i] == ref) found = static_cast<int>(base + i);
+        }
+    });
+    return found;
 }
 
 Customer* AllCustomers::findCustomerPtrByAccount(int acct)
 {
-    int idx = findIndexByAccount(acct);
-    if (idx == -1) return nullptr;
-    return &customers[idx];
+    Shard& s = shards[shardOf(acct)];
+    ensureIndexed(s);
+    unique_lock<shared_mutex> lock(s.lock);
+    auto it = s.index.find(acct);
+    if (it == s.index.end()) return nullptr;
+    markRecordEdited(makeRef(shardOf(acct), it->second)); // caller may edit through the pointer
+    return &s.records.mutableAt(it->second);
+}
+
+bool AllCustomers::findCustomer(int acct, Customer& out) const
+{
+    const Shard& s = shards[shardOf(acct)];
+    ensureIndexed(s);
+    shared_lock<shared_mutex> lock(s.lock);
+    auto it = s.index.find(acct);
+    if (it == s.index.end()) return false;
+    out = s.records[it->second];
+    return true;
+}
+
+bool AllCustomers::accountExists(int acct) const
+{
+    const Shard& s = shards[shardOf(acct)];
+    ensureIndexed(s);
+    shared_lock<shared_mutex> lock(s.lock);
+    return s.index.count(acct) != 0;
 }
 
 // --------------------- Add / Update / Delete -----------------------
@@ -195,12 +410,35 @@ Customer AllCustomers::promptForCustomer(int suggestedAcct) const
 
 void AllCustomers::addCustomer()
 {
-    int suggested = generateUniqueAccountNumber();
+    int suggested = accountNumbers.allocate();
     Customer c = promptForCustomer(suggested);
-    customers.push_back(c);
+    if (!insertCustomer(c)) {
+        cout << "Account " << c.accountNumber << " already exists; customer not added.\n";
+        return;
+    }
     cout << "Customer added (Acct " << c.accountNumber << ").\n";
 }
 
+bool AllCustomers::insertCustomer(const Customer& c)
+{
+    size_t shard = shardOf(c.accountNumber);
+    Shard& s = shards[shard];
+    ensureIndexed(s);
+    uint64_t ref;
+    {
+        unique_lock<shared_mutex> lock(s.lock);
+        if (s.index.count(c.accountNumber)) return false;
+        ref = append(shard, c);
+    }
+    accountNumbers.observe(c.accountNumber);
+    {
+        lock_guard<mutex> lock(orderMutex); // the only step all inserts share
+        order.push_back(ref);
+    }
+    revisionCount = nextRevision(); // a new slot, so nothing cached for it
+    return true;
+}
+
 void AllCustomers::addMultipleCustomersRecursive(int remaining)
 {
     if (remaining <= 0) return;
@@ -211,9 +449,8 @@ void AllCustomers::addMultipleCustomersRecursive(int remaining)
 
 bool AllCustomers::updateCustomer(int acct)
 {
-    int idx = findIndexByAccount(acct);
-    if (idx < 0) return false;
-    Customer& c = customers[idx];
+    Customer c;
+    if (!findCustomer(acct, c)) return false;
     cout << "Updating customer (leave blank to keep current)\n";
     string temp;
     cout << "First name [" << c.firstName << "]: ";
@@ -244,25 +481,81 @@ bool AllCustomers::updateCustomer(int acct)
     getline(cin, temp);
     if (!temp.empty()) c.phone = temp;
 
+    if (!replaceCustomer(c)) return false;
     cout << "Customer updated.\n";
     return true;
 }
 
+bool AllCustomers::replaceCustomer(const Customer& c)
+{
+    size_t shard = shardOf(c.accountNumber);
+    Shard& s = shards[shard];
+    ensureIndexed(s);
+    uint64_t ref;
+    {
+        unique_lock<shared_mutex> lock(s.lock);
+        auto it = s.index.find(c.accountNumber);
+        if (it == s.index.end()) return false;
+        s.records.mutableAt(it->second) = c;
+        ref = makeRef(shard, it->second);
+    }
+    markRecordEdited(ref); // only this row needs formatting again
+    return true;
+}
+
 bool AllCustomers::deleteCustomer(int acct)
 {
-    int idx = findIndexByAccount(acct);
-    if (idx < 0) return false;
-    customers.erase(customers.begin() + idx);
+    size_t shard = shardOf(acct);
+    Shard& s = shards[shard];
+    ensureIndexed(s);
+    size_t pos, last;
+    {
+        unique_lock<shared_mutex> lock(s.lock);
+        auto it = s.index.find(acct);
+        if (it == s.index.end()) return false;
+        pos = it->second;
+        last = s.records.size() - 1;
+        s.index.erase(it);
+        // move the shard's last record into the gap so no other position changes
+        if (pos != last) {
+            Customer moved = s.records[last];
+            auto m = s.index.find(moved.accountNumber);
+            if (m != s.index.end() && m->second == last) m->second = pos;
+            s.records.mutableAt(pos) = std::move(moved);
+        }
+        s.records.erase(last);
+        if (s.duplicates > 0) {
+            // a repeated account from the file takes over the index entry
+            for (size_t k = 0; k < s.records.size(); ++k) {
+                if (s.records[k].accountNumber != acct) continue;
+                s.index.emplace(acct, k);
+                --s.duplicates;
+                break;
+            }
+        }
+    }
+
+    // display order: drop the deleted row and repoint the moved one
+    const uint64_t gone = makeRef(shard, pos), moved = makeRef(shard, last);
+    size_t goneAt = order.size(), movedAt = order.size();
+    order.forEachChunk([&](const uint64_t* data, size_t len, size_t base) {
+        for (size_t i = 0; i < len; ++i) {
+            if (data[i] == gone) goneAt = base + i;
+            else if (data[i] == moved) movedAt = base + i;
+        }
+    });
+    if (pos != last && movedAt < order.size()) order.mutableAt(movedAt) = gone;
+    order.erase(goneAt);
+    markRecordEdited(gone);
+    markRecordEdited(moved); // that slot is free now; a later insert may reuse it
     return true;
 }
 
 // --------------------- Utilities -----------------------
 int AllCustomers::generateUniqueAccountNumber() const
 {
-    // generate a simple unique account number: max existing + 1, or 1000 if none
-    int maxAcct = 999;
-    for (const auto& c : customers) if (c.accountNumber > maxAcct) maxAcct = c.accountNumber;
-    return maxAcct + 1;
+    // allocator starts at max existing + 1 (or 1000) when loading, so no scan here
+    return accountNumbers.peek();
 }
 
 bool AllCustomers::isDigits(const string& s)
@@ -271,8 +564,3 @@ bool AllCustomers::isDigits(const string& s)
     for (char ch : s) if (!std::isdigit(static_cast<unsigned char>(ch))) return false;
     return true;
 }
-
-bool AllCustomers::accountExists(int acct) const
-{
-    return findIndexByAccount(acct) != -1;
-}
\ No newline at end of file
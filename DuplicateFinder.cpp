@@ -0,0 +1,305 @@
+#include "DuplicateFinder.h"
+#include <thread>
+#include <functional>
+#include <sstream>
+#include <cctype>
+
+using namespace std;
+
+// --------------------- Constructor -----------------------
+DuplicateFinder::DuplicateFinder(double minScore, unsigned threads)
+    : minScore(minScore), threadCount(threads)
+{
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+}
+
+template <typename Fn>
+void DuplicateFinder::parallelFor(size_t count, Fn fn) const
+{
+    // small inputs aren't worth starting threads for
+    unsigned workers = count < 4096 ? 1 : threadCount;
+    if (workers <= 1) {
+        fn(size_t{ 0 }, count, 0u);
+        return;
+    }
+    vector<thread> pool;
+    size_t step = (count + workers - 1) / workers;
+    for (unsigned w = 0; w < workers; ++w) {
+        size_t begin = w * step;
+        size_t end = std::min(count, begin + step);
+        if (begin >= end) break;
+        pool.emplace_back(fn, begin, end, w);
+    }
+    for (auto& t : pool) t.join();
+}
+
+// --------------------- Normalization -----------------------
+string DuplicateFinder::normalizePhone(const string& phone)
+{
+    string digits;
+    for (char ch : phone) if (isdigit(static_cast<unsigned char>(ch))) digits += ch;
+    if (digits.size() == 11 && digits[0] == '1') digits.erase(0, 1);
+    return digits;
+}
+
+string DuplicateFinder::normalizeStreet(const string& street)
+{
+    static const vector<pair<string, string>> abbreviations = {
+        { "street", "st" }, { "avenue", "ave" }, { "av", "ave" }, { "road", "rd" },
+        { "boulevard", "blvd" }, { "drive", "dr" }, { "place", "pl" }, { "lane", "ln" },
+        { "court", "ct" }, { "parkway", "pkwy" }, { "north", "n" }, { "south", "s" },
+        { "east", "e" }, { "west", "w" }
+    };
+
+    // split on anything that isn't a letter or digit
+    string cleaned;
+    for (char ch : street) {
+        unsigned char u = static_cast<unsigned char>(ch);
+        cleaned += isalnum(u) ? static_cast<char>(tolower(u)) : ' ';
+    }
+    istringstream ss(cleaned);
+    string word, result;
+    while (ss >> word) {
+        // "34th", "1st", "2nd" -> the number alone
+        size_t digits = 0;
+        while (digits < word.size() && isdigit(static_cast<unsigned char>(word[digits]))) ++digits;
+        if (digits > 0 && digits < word.size()) {
+            string suffix = word.substr(digits);
+            if (suffix == "st" || suffix == "nd" || suffix == "rd" || suffix == "th") word.resize(digits);
+        }
+        for (const auto& ab : abbreviations) {
+            if (word == ab.first) { word = ab.second; break; }
+        }
+        if (!result.empty()) result += ' ';
+        result += word;
+    }
+    return result;
+}
+
+string DuplicateFinder::normalizeZip(const string& zip)
+{
+    string digits;
+    for (char ch : zip) {
+        if (isdigit(static_cast<unsigned char>(ch))) digits += ch;
+        if (digits.size() == 5) break;
+    }
+    return digits;
+}
+
+string DuplicateFinder::normalizeName(const string& name)
+{
+    string result;
+    for (char ch : name) {
+        unsigned char u = static_cast<unsigned char>(ch);
+        if (isalpha(u)) result += static_cast<char>(tolower(u));
+    }
+    return result;
+}
+
+// --------------------- Blocking -----------------------
+// Every record gets a handful of blocking keys; two records become a
+// candidate pair only if they share one. Keys are hashed and sorted rather
+// than kept in a map of strings, which keeps the pass cache friendly.
+vector<uint64_t> DuplicateFinder::candidatePairs(const vector<Normalized>& recs) const
+{
+    const size_t keysPerRecord = 3;
+    vector<pair<uint64_t, uint32_t>> keys(recs.size() * keysPerRecord, { 0, 0 });
+    std::hash<string> hasher;
+
+    parallelFor(recs.size(), [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            const Normalized& r = recs[i];
+            uint32_t idx = static_cast<uint32_t>(i);
+            pair<uint64_t, uint32_t>* out = &keys[i * keysPerRecord];
+            // key 0 is reserved for "no key" so short or blank fields don't form one giant block
+            if (r.phone.size() >= 7) out[0] = { hasher("p|" + r.phone) | 1, idx };
+            if (!r.last.empty() && !r.zip.empty()) out[1] = { hasher("z|" + r.last + '|' + r.zip) | 1, idx };
+            if (!r.last.empty() && !r.first.empty()) out[2] = { hasher("n|" + r.first + '|' + r.last) | 1, idx };
+        }
+    });
+    keys.erase(std::remove_if(keys.begin(), keys.end(),
+        [](const pair<uint64_t, uint32_t>& k) { return k.first == 0; }), keys.end());
+    std::sort(keys.begin(), keys.end());
+
+    vector<uint64_t> pairs;
+    vector<uint32_t> block;
+    size_t start = 0;
+    while (start < keys.size()) {
+        size_t end = start + 1;
+        while (end < keys.size() && keys[end].first == keys[start].first) ++end;
+        block.clear();
+        for (size_t k = start; k < end; ++k) block.push_back(keys[k].second);
+
+        // small blocks compare everything; in bigger ones input order says
+        // nothing about similarity, so sort by street then first name and
+        // compare a sliding window of neighbours (sorted neighbourhood)
+        size_t window = block.size();
+        if (block.size() > maxFullBlock) {
+            std::sort(block.begin(), block.end(), [&recs](uint32_t a, uint32_t b) {
+                const Normalized& ra = recs[a];
+                const Normalized& rb = recs[b];
+                if (ra.street != rb.street) return ra.street < rb.street;
+                if (ra.first != rb.first) return ra.first < rb.first;
+                return a < b;
+            });
+            window = neighbourWindow;
+        }
+        for (size_t i = 0; i < block.size(); ++i) {
+            for (size_t j = i + 1; j < block.size() && j <= i + window; ++j) {
+                uint64_t a = std::min(block[i], block[j]), b = std::max(block[i], block[j]);
+                if (a == b) continue; // two keys of one record collided
+                pairs.push_back((a << 32) | b);
+            }
+        }
+        start = end;
+    }
+    // the same pair can come from several keys
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    return pairs;
+}
+
+// --------------------- Scoring -----------------------
+double DuplicateFinder::similarity(const string& a, const string& b)
+{
+    if (a.empty() || b.empty()) return 0.0;
+    if (a == b) return 1.0;
+
+    size_t range = std::max(a.size(), b.size()) / 2;
+    range = range > 0 ? range - 1 : 0;
+    vector<char> aMatched(a.size(), 0), bMatched(b.size(), 0);
+    size_t matches = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        size_t lo = i > range ? i - range : 0;
+        size_t hi = std::min(b.size(), i + range + 1);
+        for (size_t j = lo; j < hi; ++j) {
+            if (bMatched[j] || a[i] != b[j]) continue;
+            aMatched[i] = bMatched[j] = 1;
+            ++matches;
+            break;
+        }
+    }
+    if (matches == 0) return 0.0;
+
+    size_t transpositions = 0;
+    for (size_t i = 0, j = 0; i < a.size(); ++i) {
+        if (!aMatched[i]) continue;
+        while (!bMatched[j]) ++j;
+        if (a[i] != b[j]) ++transpositions;
+        ++j;
+    }
+    double m = static_cast<double>(matches);
+    double jaro = (m / a.size() + m / b.size() + (m - transpositions / 2.0) / m) / 3.0;
+
+    size_t prefix = 0;
+    while (prefix < 4 && prefix < a.size() && prefix < b.size() && a[prefix] == b[prefix]) ++prefix;
+    return jaro + prefix * 0.1 * (1.0 - jaro);
+}
+
+double DuplicateFinder::scorePair(const Normalized& a, const Normalized& b, string& reason)
+{
+    struct Field { const char* name; double weight; double sim; };
+    const Field fields[] = {
+        { "last name", 0.20, similarity(a.last, b.last) },
+        { "first name", 0.15, similarity(a.first, b.first) },
+        { "phone", 0.25, (!a.phone.empty() && a.phone == b.phone) ? 1.0 : 0.0 },
+        { "street", 0.20, similarity(a.street, b.street) },
+        { "city", 0.10, similarity(a.city, b.city) },
+        { "zip", 0.10, (!a.zip.empty() && a.zip == b.zip) ? 1.0 : 0.0 },
+    };
+    const string* values[][2] = {
+        { &a.last, &b.last }, { &a.first, &b.first }, { &a.phone, &b.phone },
+        { &a.street, &b.street }, { &a.city, &b.city }, { &a.zip, &b.zip },
+    };
+    double score = 0.0, weight = 0.0;
+    reason.clear();
+    for (size_t k = 0; k < sizeof(fields) / sizeof(fields[0]); ++k) {
+        const Field& f = fields[k];
+        // a field blank on either side is unknown, not a mismatch
+        if (values[k][0]->empty() || values[k][1]->empty()) continue;
+        score += f.weight * f.sim;
+        weight += f.weight;
+        if (f.sim >= 0.9) {
+            if (!reason.empty()) reason += ", ";
+            reason += f.name;
+        }
+    }
+    return weight > 0.0 ? score / weight : 0.0;
+}
+
+// --------------------- Search -----------------------
+vector<DuplicateMatch> DuplicateFinder::find(const AllCustomers& customers) const
+{
+    vector<Normalized> recs(customers.size());
+    parallelFor(recs.size(), [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            const Customer& c = customers.at(i);
+            Normalized& r = recs[i];
+            r.first = normalizeName(c.firstName);
+            r.last = normalizeName(c.lastName);
+            r.street = normalizeStreet(c.street);
+            r.city = normalizeName(c.city);
+            r.zip = normalizeZip(c.zip);
+            r.phone = normalizePhone(c.phone);
+        }
+    });
+
+    vector<uint64_t> pairs = candidatePairs(recs);
+
+    // each worker collects its own matches, merged afterwards
+    vector<vector<DuplicateMatch>> perWorker(threadCount);
+    parallelFor(pairs.size(), [&](size_t begin, size_t end, unsigned worker) {
+        string reason;
+        for (size_t p = begin; p < end; ++p) {
+            size_t i = static_cast<size_t>(pairs[p] >> 32);
+            size_t j = static_cast<size_t>(pairs[p] & 0xFFFFFFFFu);
+            int acctA = customers.at(i).accountNumber;
+            int acctB = customers.at(j).accountNumber;
+            if (acctA == acctB) continue; // one account repeated in the file, not a person under two accounts
+            double score = scorePair(recs[i], recs[j], reason);
+            if (score < minScore) continue;
+            DuplicateMatch m;
+            m.accountA = std::min(acctA, acctB);
+            m.accountB = std::max(acctA, acctB);
+            m.score = score;
+            m.reason = reason;
+            perWorker[worker].push_back(m);
+        }
+    });
+
+    vector<DuplicateMatch> matches;
+    for (auto& part : perWorker) matches.insert(matches.end(), part.begin(), part.end());
+    // repeated accounts can yield the same account pair from several rows; keep the best score
+    std::sort(matches.begin(), matches.end(), [](const DuplicateMatch& a, const DuplicateMatch& b) {
+        if (a.accountA != b.accountA) return a.accountA < b.accountA;
+        if (a.accountB != b.accountB) return a.accountB < b.accountB;
+        return a.score > b.score;
+    });
+    matches.erase(std::unique(matches.begin(), matches.end(), [](const DuplicateMatch& a, const DuplicateMatch& b) {
+        return a.accountA == b.accountA && a.accountB == b.accountB;
+    }), matches.end());
+    std::stable_sort(matches.begin(), matches.end(), // equal scores stay in account order
+        [](const DuplicateMatch& a, const DuplicateMatch& b) { return a.score > b.score; });
+    return matches;
+}
+
+void DuplicateFinder::printMatches(const vector<DuplicateMatch>& matches, std::ostream& out)
+{
+    if (matches.empty()) {
+        out << "No likely duplicates found.\n";
+        return;
+    }
+    ostringstream buf;
+    buf << left << setw(10) << "Account" << setw(10) << "Account"
+        << setw(8) << "Score" << "Matching fields" << '\n';
+    buf << string(72, '-') << '\n';
+    buf << fixed << setprecision(2);
+    for (const auto& m : matches) {
+        buf << setw(10) << m.accountA << setw(10) << m.accountB
+            << setw(8) << m.score << m.reason << '\n';
+    }
+    buf << matches.size() << " likely duplicate pair(s).\n";
+    const string text = buf.str();
+    out.write(text.data(), static_cast<streamsize>(text.size()));
+}
@@ -0,0 +1,63 @@
+#ifndef DUPLICATEFINDER_H
+#define DUPLICATEFINDER_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdint>
+#include "AllCustomers.h"
+
+using namespace std;
+
+struct DuplicateMatch {
+    int accountA{ 0 }; // accountA < accountB; each pair is reported once
+    int accountB{ 0 };
+    double score{ 0.0 }; // 0..1, higher means more likely the same person
+    string reason;       // which fields agreed, e.g. "phone, last name"
+};
+
+// Finds customers that were probably entered twice under different account
+// numbers. Records are normalized (phone digits, street abbreviations, ZIP)
+// and grouped by blocking keys; only records sharing a key are compared, so
+// the work grows with the number of records instead of the number of pairs.
+// Normalizing and scoring are split across worker threads.
+class DuplicateFinder {
+public:
+    explicit DuplicateFinder(double minScore = 0.75, unsigned threads = 0); // 0 = one per core
+
+    vector<DuplicateMatch> find(const AllCustomers& customers) const; // best matches first
+    static void printMatches(const vector<DuplicateMatch>& matches, std::ostream& out = std::cout);
+
+    // Normalization helpers
+    static string normalizePhone(const string& phone);   // digits only, no leading 1
+    static string normalizeStreet(const string& street); // lower case, "Avenue" -> "ave", "34th" -> "34"
+    static string normalizeZip(const string& zip);       // first five digits
+    static string normalizeName(const string& name);     // lower case letters only
+
+private:
+    struct Normalized {
+        string first;
+        string last;
+        string street;
+        string city;
+        string zip;
+        string phone;
+    };
+
+    double minScore;
+    unsigned threadCount;
+
+    // Largest block compared all-pairs; bigger blocks are sorted by street
+    // and first name and only compare that many neighbours
+    static const size_t maxFullBlock = 64;
+    static const size_t neighbourWindow = 16;
+
+    vector<uint64_t> candidatePairs(const vector<Normalized>& recs) const;
+    static double scorePair(const Normalized& a, const Normalized& b, string& reason);
+    static double similarity(const string& a, const string& b); // Jaro-Winkler
+
+    template <typename Fn>
+    void parallelFor(size_t count, Fn fn) const; // fn(begin, end, worker)
+};
+
+#endif // DUPLICATEFINDER_H
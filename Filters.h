@@ -0,0 +1,234 @@
+#ifndef FILTERS_H
+#define FILTERS_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <initializer_list>
+#include <type_traits>
+#include "AllCustomers.h"
+#include "AllPurchases.h"
+
+using namespace std;
+
+// Filter expressions over Customer and Purchase fields, e.g.
+//
+//   using namespace filter;
+//   auto ny = accounts(customers, field<&Customer::state> == "NY");
+//   auto big = field<&Purchase::amount> > 30000.0
+//           && field<&Purchase::brand>.in({ "Toyota", "Ford" })
+//           && field<&Purchase::accountNumber>.inSorted(ny);
+//   double revenue = sum(purchases, big, &Purchase::amount);
+//
+// Every expression is its own type, so each query compiles into its own
+// scan loop with the comparisons inlined; nothing is interpreted per row.
+// && and || evaluate both sides and combine with & and | so the loop has no
+// data-dependent branches to mispredict.
+namespace filter {
+
+    template <typename> struct MemberOf;
+    template <typename C, typename T> struct MemberOf<T C::*> {
+        using record = C;
+        using type = T;
+    };
+
+    // --------------------- Comparison ops -----------------------
+    inline bool sameString(const string& a, const string& b)
+    {
+        return (a.size() == b.size()) & (std::memcmp(a.data(), b.data(), std::min(a.size(), b.size())) == 0);
+    }
+
+    struct Eq {
+        template <typename A> static bool apply(const A& a, const A& b) { return a == b; }
+        static bool apply(const string& a, const string& b) { return sameString(a, b); }
+    };
+    struct Ne {
+        template <typename A> static bool apply(const A& a, const A& b) { return !Eq::apply(a, b); }
+    };
+    struct Lt { template <typename A> static bool apply(const A& a, const A& b) { return a < b; } };
+    struct Le { template <typename A> static bool apply(const A& a, const A& b) { return a <= b; } };
+    struct Gt { template <typename A> static bool apply(const A& a, const A& b) { return a > b; } };
+    struct Ge { template <typename A> static bool apply(const A& a, const A& b) { return a >= b; } };
+
+    // --------------------- Expression nodes -----------------------
+    template <typename Derived> struct Expr {}; // marks types that take part in && || !
+
+    template <auto Member, typename Op>
+    struct Compare : Expr<Compare<Member, Op>> {
+        typename MemberOf<decltype(Member)>::type value;
+        template <typename Rec> bool operator()(const Rec& r) const { return Op::apply(r.*Member, value); }
+    };
+
+    // Membership in a short list: every entry is checked and OR-ed together
+    template <auto Member>
+    struct InList : Expr<InList<Member>> {
+        vector<typename MemberOf<decltype(Member)>::type> values;
+        template <typename Rec> bool operator()(const Rec& r) const
+        {
+            bool hit = false;
+            for (const auto& v : values) hit |= Eq::apply(r.*Member, v);
+            return hit;
+        }
+    };
+
+    // Membership in a long sorted list (e.g. account numbers from accounts())
+    template <auto Member>
+    struct InSorted : Expr<InSorted<Member>> {
+        vector<typename MemberOf<decltype(Member)>::type> values;
+        template <typename Rec> bool operator()(const Rec& r) const
+        {
+            return std::binary_search(values.begin(), values.end(), r.*Member);
+        }
+    };
+
+    template <typename L, typename R>
+    struct And : Expr<And<L, R>> {
+        L left;
+        R right;
+        template <typename Rec> bool operator()(const Rec& r) const { return left(r) & right(r); }
+    };
+
+    template <typename L, typename R>
+    struct Or : Expr<Or<L, R>> {
+        L left;
+        R right;
+        template <typename Rec> bool operator()(const Rec& r) const { return left(r) | right(r); }
+    };
+
+    template <typename E>
+    struct Not : Expr<Not<E>> {
+        E inner;
+        template <typename Rec> bool operator()(const Rec& r) const { return !inner(r); }
+    };
+
+    template <typename L, typename R>
+    And<L, R> operator&&(const Expr<L>& l, const Expr<R>& r)
+    {
+        return And<L, R>{ {}, static_cast<const L&>(l), static_cast<const R&>(r) };
+    }
+
+    template <typename L, typename R>
+    Or<L, R> operator||(const Expr<L>& l, const Expr<R>& r)
+    {
+        return Or<L, R>{ {}, static_cast<const L&>(l), static_cast<const R&>(r) };
+    }
+
+    template <typename E>
+    Not<E> operator!(const Expr<E>& e)
+    {
+        return Not<E>{ {}, static_cast<const E&>(e) };
+    }
+
+    // --------------------- Field references -----------------------
+    template <auto Member>
+    struct Field {
+        using value_type = typename MemberOf<decltype(Member)>::type;
+
+        Compare<Member, Eq> operator==(const value_type& v) const { return { {}, v }; }
+        Compare<Member, Ne> operator!=(const value_type& v) const { return { {}, v }; }
+        Compare<Member, Lt> operator<(const value_type& v) const { return { {}, v }; }
+        Compare<Member, Le> operator<=(const value_type& v) const { return { {}, v }; }
+        Compare<Member, Gt> operator>(const value_type& v) const { return { {}, v }; }
+        Compare<Member, Ge> operator>=(const value_type& v) const { return { {}, v }; }
+
+        InList<Member> in(initializer_list<value_type> values) const { return { {}, vector<value_type>(values) }; }
+        InSorted<Member> inSorted(vector<value_type> values) const
+        {
+            std::sort(values.begin(), values.end());
+            return { {}, std::move(values) };
+        }
+    };
+
+    template <auto Member>
+    constexpr Field<Member> field{};
+
+    // --------------------- Scan kernels -----------------------
+    // Indices of matching records. Each slot is written unconditionally and
+    // the count only advances on a match, so the loop body has no branch.
+    template <typename Rec, typename Pred>
+    vector<size_t> select(const CowVector<Rec>& recs, const Pred& pred)
+    {
+        vector<size_t> out;
+        size_t n = 0;
+        recs.forEachChunk([&](const Rec* data, size_t len, size_t base) {
+            out.resize(n + len);
+            size_t* dst = out.data();
+            for (size_t i = 0; i < len; ++i) {
+                dst[n] = base + i;
+                n += pred(data[i]);
+            }
+        });
+        out.resize(n);
+        return out;
+    }
+
+    template <typename Rec, typename Pred>
+    size_t count(const CowVector<Rec>& recs, const Pred& pred)
+    {
+        size_t n = 0;
+        recs.forEachChunk([&](const Rec* data, size_t len, size_t) {
+            for (size_t i = 0; i < len; ++i) n += pred(data[i]);
+        });
+        return n;
+    }
+
+    template <typename Rec, typename Pred, typename T>
+    double sum(const CowVector<Rec>& recs, const Pred& pred, T Rec::* member)
+    {
+        double total = 0.0;
+        recs.forEachChunk([&](const Rec* data, size_t len, size_t) {
+            // a select rather than pred * value: 0 * NaN or 0 * inf would poison the total
+            for (size_t i = 0; i < len; ++i) total += pred(data[i]) ? static_cast<double>(data[i].*member) : 0.0;
+        });
+        return total;
+    }
+
+    // Convenience overloads for the two tables
+    template <typename Pred> vector<size_t> select(const AllPurchases& p, const Pred& pred) { return select(p.records(), pred); }
+    template <typename Pred> size_t count(const AllPurchases& p, const Pred& pred) { return count(p.records(), pred); }
+
+    // Customers live in shards, so select walks the display order to return
+    // indices for at(); count and accounts scan the shards' chunks directly
+    template <typename Pred>
+    vector<size_t> select(const AllCustomers& customers, const Pred& pred)
+    {
+        vector<size_t> out;
+        for (size_t i = 0; i < customers.size(); ++i) {
+            if (pred(customers.at(i))) out.push_back(i);
+        }
+        return out;
+    }
+
+    template <typename Pred>
+    size_t count(const AllCustomers& customers, const Pred& pred)
+    {
+        size_t n = 0;
+        customers.forEachChunk([&](const Customer* data, size_t len) {
+            for (size_t i = 0; i < len; ++i) n += pred(data[i]);
+        });
+        return n;
+    }
+    template <typename Pred, typename T> double sum(const AllPurchases& p, const Pred& pred, T Purchase::* member)
+    {
+        return sum(p.records(), pred, member);
+    }
+
+    // Sorted account numbers of matching customers; feed to
+    // field<&Purchase::accountNumber>.inSorted() to filter purchases by customer fields
+    template <typename Pred>
+    vector<int> accounts(const AllCustomers& customers, const Pred& pred)
+    {
+        vector<int> accts;
+        customers.forEachChunk([&](const Customer* data, size_t len) {
+            for (size_t i = 0; i < len; ++i) {
+                if (pred(data[i])) accts.push_back(data[i].accountNumber);
+            }
+        });
+        std::sort(accts.begin(), accts.end());
+        accts.erase(std::unique(accts.begin(), accts.end()), accts.end());
+        return accts;
+    }
+}
+
+#endif // FILTERS_H
@@ -1,7 +1,11 @@
 #include <iostream>
 #include <limits>
+#include <mutex>
 #include "AllCustomers.h"
 #include "AllPurchases.h"
+#include "BackgroundSaver.h"
+#include "DuplicateFinder.h"
+#include "RevenueCube.h"
 
 using namespace std;
 
@@ -10,6 +14,12 @@ void pause() {
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
 }
 
+// Waits for Enter with the data unlocked so autosave can run meanwhile
+void pause(unique_lock<mutex>& dataLock) {
+    dataLock.unlock();
+    pause();
+}
+
 // Helper: prompt for integer with validation
 int promptInt(const string& msg) {
     string s;
@@ -24,12 +34,60 @@ int promptInt(const string& msg) {
     }
 }
 
+// Rows shown per page when listing customers
+const size_t customersPerPage = 20;
+
+// Pages through the customer table. Returns the 1-based customer number the
+// user picked, or -1 if they cancel. With allowSelect false it only browses.
+int selectCustomerPaged(const AllCustomers& customers, const string& msg, bool allowSelect = true) {
+    size_t page = 0;
+    while (true) {
+        customers.printCustomersPage(page, customersPerPage);
+        if (customers.size() == 0) return -1;
+        cout << msg;
+        string s;
+        getline(cin, s);
+        if (s.empty()) return -1;
+        if (s == "n" || s == "N") {
+            if (page + 1 < customers.pageCount(customersPerPage)) ++page;
+            continue;
+        }
+        if (s == "p" || s == "P") {
+            if (page > 0) --page;
+            continue;
+        }
+        if (!allowSelect) return -1;
+        bool ok = true;
+        for (char ch : s) if (!isdigit(static_cast<unsigned char>(ch))) { ok = false; break; }
+        if (!ok) { cout << "Please enter digits, 'n' or 'p'." << endl; continue; }
+        return stoi(s);
+    }
+}
+
+// Feeds customers added since `from` to the cube (they may own existing purchases)
+void cubeAddCustomers(RevenueCube& cube, const AllCustomers& customers, size_t from) {
+    for (size_t i = from; i < customers.size(); ++i)
+        cube.setCustomerState(customers.at(i).accountNumber, customers.at(i).state);
+}
+
+// Feeds purchases added since `from` to the cube
+void cubeAddPurchases(RevenueCube& cube, const AllPurchases& purchases, size_t from) {
+    for (size_t i = from; i < purchases.size(); ++i) cube.addPurchase(purchases.get(i));
+}
+
+void printRollup(const RevenueCube& cube, const string& month, const string& brand, const string& state) {
+    RevenueCell total = cube.query(month, brand, state);
+    cout << "Month " << month << ", brand " << brand << ", state " << state << ": $"
+        << fixed << setprecision(2) << total.revenue << " (" << total.count << " purchases)" << endl;
+}
+
 int main() {
     AllCustomers customers;
     AllPurchases purchases;
 
     const string defaultCustFile = "customers.txt";
     const string defaultPurchFile = "purchases.txt";
+    const string defaultCubeFile = "revenue_cube.txt";
     ;
     cout << "   Welcome to Car World Inventory  " << endl;
     cout << "  Manage customers and purchases easily  " << endl;
@@ -48,6 +106,14 @@ int main() {
     else {
         cout << "No purchases file found. Starting with no data." << endl;
     }
+    RevenueCube cube;
+    if (!cube.loadFromFile(defaultCubeFile, customers, purchases)) {
+        cube.rebuild(customers, purchases); // missing or out of date
+    }
+    mutex dataMutex; // must outlive saver
+    BackgroundSaver saver(defaultCustFile, defaultPurchFile, defaultCubeFile);
+    saver.markClean(customers, purchases);
+    saver.watch(customers, purchases, dataMutex, &cube);
 
     while (true) {
         cout << "========== MAIN MENU ==========" << endl
@@ -65,28 +131,31 @@ int main() {
             << "12) Save data (overwrite)" << endl
             << "13) Export data" << endl
             << "14) Exit" << endl
+            << "15) Save status / autosave" << endl
+            << "16) Find likely duplicate customers" << endl
+            << "17) Revenue by month / brand / state" << endl
             << "Choose an option: ";
         string choice;
         getline(cin, choice);
         if (choice.empty()) continue;
+        // held for the whole action so autosave never copies a half-edited record
+        unique_lock<mutex> dataLock(dataMutex);
 
         if (choice == "1") {
-            customers.printAllCustomers();
-            pause();
+            selectCustomerPaged(customers, "'n' next page, 'p' previous page, Enter to return: ", false);
         }
         else if (choice == "2") {
             customers.sortAscending();
             cout << "Sorted ascending." << endl;
-            pause();
+            pause(dataLock);
         }
         else if (choice == "3") {
             customers.sortDescending();
             cout << "Sorted descending." << endl;
-            pause();
+            pause(dataLock);
         }
         else if (choice == "4") {
-            customers.printAllCustomers();
-            int idx = promptInt("Select customer by number (or 0 to cancel): ");
+            int idx = selectCustomerPaged(customers, "Select customer by number, 'n'/'p' to change page (or 0 to cancel): ");
             if (idx <= 0) continue;
             if (static_cast<size_t>(idx) > customers.size()) {
                 std::cout << "Invalid selection." << endl; continue;
@@ -96,40 +165,44 @@ int main() {
             customers.printCustomerByIndex(idx - 1);
             cout << "Purchases" << endl;
             purchases.printCustomerPurchases(acct);
-            pause();
+            pause(dataLock);
         }
         else if (choice == "5") {
-            customers.printAllCustomers();
-            int idx = promptInt("Select customer by number to view total spend (or 0 to cancel): ");
+            int idx = selectCustomerPaged(customers, "Select customer by number to view total spend, 'n'/'p' to change page (or 0 to cancel): ");
             if (idx <= 0) continue;
             if (static_cast<size_t>(idx) > customers.size()) { cout << "Invalid selection." << endl; continue; }
             int acct = customers.at(idx - 1).accountNumber;
             double total = purchases.totalCustomerSpend(acct);
             cout << "Total spend for account " << acct << ": $" << fixed << setprecision(2) << total << endl;
-            pause();
+            pause(dataLock);
         }
         else if (choice == "6") {
+            size_t before = customers.size();
             customers.addCustomer();
-            pause();
+            cubeAddCustomers(cube, customers, before);
+            pause(dataLock);
         }
         else if (choice == "7") {
             int n = promptInt("How many customers to add (or 0 to cancel): ");
+            size_t before = customers.size();
             if (n > 0) customers.addMultipleCustomersRecursive(n);
-            pause();
+            cubeAddCustomers(cube, customers, before);
+            pause(dataLock);
         }
         else if (choice == "8") {
-            customers.printAllCustomers();
-            int idx = promptInt("Select customer number to update (or 0 to cancel): ");
+            int idx = selectCustomerPaged(customers, "Select customer number to update, 'n'/'p' to change page (or 0 to cancel): ");
             if (idx <= 0) continue;
             if (static_cast<size_t>(idx) > customers.size()) { std::cout << "Invalid selection." << endl; continue; }
             int acct = customers.at(idx - 1).accountNumber;
-            if (customers.updateCustomer(acct)) cout << "Updated.\n";
+            if (customers.updateCustomer(acct)) {
+                cube.setCustomerState(acct, customers.at(idx - 1).state);
+                cout << "Updated.\n";
+            }
             else cout << "Failed to update." << endl;
-            pause();
+            pause(dataLock);
         }
         else if (choice == "9") {
-            customers.printAllCustomers();
-            int idx = promptInt("Select customer number to delete (or 0 to cancel): ");
+            int idx = selectCustomerPaged(customers, "Select customer number to delete, 'n'/'p' to change page (or 0 to cancel): ");
             if (idx <= 0) continue;
             if (static_cast<size_t>(idx) > customers.size()) { cout << "Invalid selection." << endl; continue; }
             int acct = customers.at(idx - 1).accountNumber;
@@ -138,28 +211,31 @@ int main() {
             if (!y.empty() && (y[0] == 'y' || y[0] == 'Y')) {
                 if (customers.deleteCustomer(acct)) {
                     purchases.deletePurchasesForCustomer(acct); // remove linked purchases
+                    cube.removeAccount(acct);
                     cout << "Deleted customer and their purchases." << endl;
                 }
                 else cout << "Delete failed." << endl;
             }
             else cout << "Delete canceled." << endl;
-            pause();
+            pause(dataLock);
         }
         else if (choice == "10") {
+            size_t before = purchases.size();
             purchases.addPurchaseInteractive();
-            pause();
+            cubeAddPurchases(cube, purchases, before);
+            pause(dataLock);
         }
         else if (choice == "11") {
             int n = promptInt("How many purchases to add (or 0 to cancel): ");
+            size_t before = purchases.size();
             if (n > 0) purchases.addMultiplePurchasesRecursive(n);
-            pause();
+            cubeAddPurchases(cube, purchases, before);
+            pause(dataLock);
         }
         else if (choice == "12") {
-            if (customers.saveToFile(defaultCustFile) && purchases.saveToFile(defaultPurchFile)) {
-                cout << "Saved to default files." << endl;
-            }
-            else cout << "Failed to save data." << endl;
-            pause();
+            saver.saveAsync(customers, purchases, &cube);
+            cout << "Saving to default files in the background (see option 15 for status)." << endl;
+            pause(dataLock);
         }
         else if (choice == "13") {
             string exportFile = "output.txt";
@@ -167,7 +243,7 @@ int main() {
 
             if (!out) {
                 cout << "ERROR: Could not open " << exportFile << " for writing." << endl;
-                pause();
+                pause(dataLock);
                 continue;
             }
 
@@ -206,18 +282,63 @@ int main() {
 
             out.close();
             cout << "Data successfully exported to " << exportFile << endl;
-            pause();
+            pause(dataLock);
         }
         else if (choice == "14") {
             cout << "Exiting. Would you like to save changes? (y/n): ";
             string s; getline(cin, s);
             if (!s.empty() && (s[0] == 'y' || s[0] == 'Y')) {
-                customers.saveToFile(defaultCustFile);
-                purchases.saveToFile(defaultPurchFile);
-                cout << "Saved." << endl;
+                if (saver.saveNow(customers, purchases, &cube)) cout << "Saved." << endl;
+                else cout << saver.status() << endl;
+            }
+            else if (saver.isSaving()) {
+                cout << "Waiting for background save to finish..." << endl;
+                saver.waitForIdle();
             }
             cout << "Goodbye! And thank you for the 100!" << endl;
             break;
+        }
+        else if (choice == "15") {
+            cout << saver.status() << endl;
+            if (saver.hasUnsavedChanges(customers, purchases)) cout << "There are unsaved changes." << endl;
+            cout << "Autosave runs in the background while the menu is idle; it waits while an option is in progress." << endl;
+            int secs = promptInt("Autosave interval in seconds (0 = off, Enter to keep): ");
+            if (secs >= 0) {
+                saver.setAutosaveInterval(secs);
+                cout << (secs > 0 ? "Autosave enabled." : "Autosave disabled.") << endl;
+            }
+            pause(dataLock);
+        }
+        else if (choice == "16") {
+            DuplicateFinder finder;
+            DuplicateFinder::printMatches(finder.find(customers));
+            pause(dataLock);
+        }
+        else if (choice == "17") {
+            string month, brand, state;
+            cout << "Month (YYYY-MM, Enter for all): ";
+            getline(cin, month);
+            cout << "Brand (Enter for all): ";
+            getline(cin, brand);
+            cout << "State (Enter for all): ";
+            getline(cin, state);
+            if (month.empty()) month = RevenueCube::All;
+            if (brand.empty()) brand = RevenueCube::All;
+            if (state.empty()) state = RevenueCube::All;
+            printRollup(cube, month, brand, state);
+
+            cout << "Drill down by (m)onth, (b)rand, (s)tate or Enter to return: ";
+            string d; getline(cin, d);
+            if (!d.empty() && (d[0] == 'm' || d[0] == 'b' || d[0] == 's')) {
+                RevenueCube::Dimension dim = d[0] == 'm' ? RevenueCube::Month
+                    : d[0] == 'b' ? RevenueCube::Brand : RevenueCube::State;
+                for (const auto& row : cube.drillDown(dim, month, brand, state)) {
+                    cout << "  " << left << setw(15) << (row.first.empty() ? "(none)" : row.first)
+                        << right << setw(14) << fixed << setprecision(2) << row.second.revenue
+                        << setw(8) << row.second.count << endl;
+                }
+            }
+            pause(dataLock);
         }
             else {
                 cout << "Invalid selection." << endl;
@@ -0,0 +1,293 @@
+#include "RevenueCube.h"
+#include <sstream>
+#include <cmath>
+
+using namespace std;
+
+const string RevenueCube::All = "*";
+
+// --------------------- Building -----------------------
+void RevenueCube::clear()
+{
+    cells.clear();
+    for (auto& m : members) m.clear();
+    accountState.clear();
+    byAccount.clear();
+    accountHash.clear();
+    purchaseCount = 0;
+    purchaseHash = 0;
+    stateHash = 0;
+}
+
+void RevenueCube::rebuild(const AllCustomers& customers, const AllPurchases& purchases)
+{
+    clear();
+    for (size_t i = 0; i < customers.size(); ++i) {
+        const Customer& c = customers.at(i);
+        accountState[c.accountNumber] = c.state; // last one wins if an account repeats
+    }
+    for (const auto& entry : accountState) stateHash += stateHashOf(entry.first, entry.second);
+    for (const auto& p : purchases.records()) addPurchase(p);
+}
+
+void RevenueCube::addPurchase(const Purchase& p)
+{
+    MonthBrand mb(monthOf(p.date), p.brand);
+    apply(mb.first, mb.second, stateOf(p.accountNumber), p.amount, 1);
+    addToAccount(p.accountNumber, mb, p.amount, 1);
+    ++purchaseCount;
+    uint64_t h = purchaseHashOf(p);
+    purchaseHash += h;
+    accountHash[p.accountNumber] += h;
+}
+
+void RevenueCube::removeAccount(int acct)
+{
+    auto it = byAccount.find(acct);
+    if (it != byAccount.end()) {
+        string state = stateOf(acct);
+        for (const auto& entry : it->second) {
+            const RevenueCell& cell = entry.second;
+            apply(entry.first.first, entry.first.second, state, -cell.revenue, -cell.count);
+            purchaseCount -= static_cast<size_t>(cell.count);
+        }
+        byAccount.erase(it);
+    }
+    auto hashIt = accountHash.find(acct);
+    if (hashIt != accountHash.end()) {
+        purchaseHash -= hashIt->second;
+        accountHash.erase(hashIt);
+    }
+    auto stateIt = accountState.find(acct);
+    if (stateIt != accountState.end()) {
+        stateHash -= stateHashOf(acct, stateIt->second);
+        accountState.erase(stateIt);
+    }
+}
+
+void RevenueCube::setCustomerState(int acct, const string& state)
+{
+    auto known = accountState.find(acct);
+    string old = known == accountState.end() ? string() : known->second;
+    if (known != accountState.end()) stateHash -= stateHashOf(acct, old);
+    stateHash += stateHashOf(acct, state);
+    accountState[acct] = state;
+    if (old == state) return;
+    auto it = byAccount.find(acct);
+    if (it == byAccount.end()) return;
+    for (const auto& entry : it->second) {
+        const RevenueCell& cell = entry.second;
+        apply(entry.first.first, entry.first.second, old, -cell.revenue, -cell.count);
+        apply(entry.first.first, entry.first.second, state, cell.revenue, cell.count);
+    }
+}
+
+void RevenueCube::apply(const string& month, const string& brand, const string& state, double amount, long count)
+{
+    members[Month].insert(month);
+    members[Brand].insert(brand);
+    members[State].insert(state);
+    // every combination of "this member" and "all" for the three dimensions
+    for (int mask = 0; mask < 8; ++mask) {
+        string key = cellKey(mask & 1 ? All : month, mask & 2 ? All : brand, mask & 4 ? All : state);
+        RevenueCell& cell = cells[key];
+        cell.revenue += amount;
+        cell.count += count;
+        if (cell.count <= 0) cells.erase(key);
+    }
+}
+
+void RevenueCube::addToAccount(int acct, const MonthBrand& mb, double amount, long count)
+{
+    auto& perAccount = byAccount[acct];
+    RevenueCell& cell = perAccount[mb];
+    cell.revenue += amount;
+    cell.count += count;
+    if (cell.count <= 0) perAccount.erase(mb);
+    if (perAccount.empty()) byAccount.erase(acct);
+}
+
+string RevenueCube::stateOf(int acct) const
+{
+    auto it = accountState.find(acct);
+    return it == accountState.end() ? string() : it->second; // purchases without a customer roll up under ""
+}
+
+string RevenueCube::cellKey(const string& month, const string& brand, const string& state)
+{
+    string key;
+    key.reserve(month.size() + brand.size() + state.size() + 2);
+    key += month;
+    key += '\x1f';
+    key += brand;
+    key += '\x1f';
+    key += state;
+    return key;
+}
+
+namespace {
+    // FNV-1a; fixed so checksums stay valid across builds and platforms
+    uint64_t fnv1a(const string& text)
+    {
+        uint64_t h = 14695981039346656037ull;
+        for (unsigned char ch : text) {
+            h ^= ch;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+}
+
+uint64_t RevenueCube::purchaseHashOf(const Purchase& p)
+{
+    // amount in cents, which survives the purchases file's round trip
+    long long cents = std::isfinite(p.amount) ? std::llround(p.amount * 100.0) : -1;
+    return fnv1a(to_string(p.accountNumber) + '\x1f' + p.date + '\x1f' + p.brand + '\x1f' + to_string(cents));
+}
+
+uint64_t RevenueCube::stateHashOf(int acct, const string& state)
+{
+    return fnv1a(to_string(acct) + '\x1f' + state);
+}
+
+string RevenueCube::monthOf(const string& date)
+{
+    // expects YYYY-MM-DD; anything else is grouped as "unknown"
+    if (date.size() >= 7 && date[4] == '-') return date.substr(0, 7);
+    return "unknown";
+}
+
+// --------------------- Queries -----------------------
+RevenueCell RevenueCube::query(const string& month, const string& brand, const string& state) const
+{
+    auto it = cells.find(cellKey(month, brand, state));
+    return it == cells.end() ? RevenueCell() : it->second;
+}
+
+vector<pair<string, RevenueCell>> RevenueCube::drillDown(Dimension dim, const string& month,
+    const string& brand, const string& state) const
+{
+    vector<pair<string, RevenueCell>> result;
+    for (const string& member : members[dim]) {
+        RevenueCell cell = query(dim == Month ? member : month,
+            dim == Brand ? member : brand,
+            dim == State ? member : state);
+        if (cell.count > 0) result.emplace_back(member, cell);
+    }
+    return result;
+}
+
+// --------------------- File I/O -----------------------
+// Only the per-account totals, checksums and states are stored; the roll-up
+// cells are derived from them on load, which is proportional to accounts x
+// months x brands rather than to the number of purchases.
+bool RevenueCube::saveToFile(const string& filename) const
+{
+    ofstream out(filename);
+    if (!out) return false;
+    out << setprecision(17);
+    // header: checksums of the purchases and customer states this cube was built from
+    out << "cube," << purchaseCount << ',' << purchaseHash << ',' << stateHash << '\n';
+    for (const auto& entry : accountState) {
+        out << "state," << entry.first << ',' << entry.second << '\n';
+    }
+    for (const auto& entry : accountHash) {
+        out << "hash," << entry.first << ',' << entry.second << '\n';
+    }
+    for (const auto& acct : byAccount) {
+        for (const auto& entry : acct.second) {
+            out << "rev," << acct.first << ','
+                << entry.first.first << ','
+                << entry.first.second << ','
+                << entry.second.count << ','
+                << entry.second.revenue << '\n';
+        }
+    }
+    out.flush();
+    return out.good();
+}
+
+bool RevenueCube::parse(istream& in, size_t& expectedCount, uint64_t& expectedPurchaseHash,
+    uint64_t& expectedStateHash)
+{
+    bool headerSeen = false;
+    string line;
+    while (getline(in, line)) {
+        if (line.empty()) continue;
+        istringstream ss(line);
+        string token;
+        vector<string> fields;
+        while (getline(ss, token, ',')) fields.push_back(token);
+        if (fields[0] == "cube" && fields.size() >= 4) {
+            expectedCount = static_cast<size_t>(stoull(fields[1]));
+            expectedPurchaseHash = stoull(fields[2]);
+            expectedStateHash = stoull(fields[3]);
+            headerSeen = true;
+        }
+        else if (fields[0] == "state" && fields.size() >= 2) {
+            int acct = stoi(fields[1]);
+            string state = fields.size() >= 3 ? fields[2] : string();
+            if (accountState.emplace(acct, state).second) stateHash += stateHashOf(acct, state);
+        }
+        else if (fields[0] == "hash" && fields.size() >= 3) {
+            uint64_t h = stoull(fields[2]);
+            accountHash[stoi(fields[1])] += h;
+            purchaseHash += h;
+        }
+        else if (fields[0] == "rev" && fields.size() >= 6) {
+            int acct = stoi(fields[1]);
+            MonthBrand mb(fields[2], fields[3]);
+            long count = stol(fields[4]);
+            double revenue = stod(fields[5]);
+            if (count <= 0) return false;
+            addToAccount(acct, mb, revenue, count);
+            purchaseCount += static_cast<size_t>(count);
+        }
+    }
+    return headerSeen;
+}
+
+bool RevenueCube::loadFromFile(const string& filename, const AllCustomers& customers, const AllPurchases& purchases)
+{
+    ifstream in(filename);
+    if (!in) return false;
+
+    clear();
+    size_t expectedCount = 0;
+    uint64_t expectedPurchaseHash = 0, expectedStateHash = 0;
+    bool ok;
+    try {
+        ok = parse(in, expectedCount, expectedPurchaseHash, expectedStateHash);
+    }
+    catch (const std::exception&) {
+        ok = false; // a malformed number; the caller rebuilds the cube
+    }
+
+    // the file has to agree with itself...
+    ok = ok && purchaseCount == expectedCount && purchaseHash == expectedPurchaseHash
+        && stateHash == expectedStateHash;
+
+    // ...and with the data files, which autosave writes without the cube
+    if (ok) {
+        uint64_t dataPurchaseHash = 0;
+        for (const auto& p : purchases.records()) dataPurchaseHash += purchaseHashOf(p);
+        unordered_map<int, string> states;
+        for (size_t i = 0; i < customers.size(); ++i) states[customers.at(i).accountNumber] = customers.at(i).state;
+        uint64_t dataStateHash = 0;
+        for (const auto& entry : states) dataStateHash += stateHashOf(entry.first, entry.second);
+        ok = expectedCount == purchases.size() && expectedPurchaseHash == dataPurchaseHash
+            && states.size() == accountState.size() && expectedStateHash == dataStateHash;
+    }
+    if (!ok) {
+        clear();
+        return false;
+    }
+
+    for (const auto& acct : byAccount) {
+        string state = stateOf(acct.first);
+        for (const auto& entry : acct.second) {
+            apply(entry.first.first, entry.first.second, state, entry.second.revenue, entry.second.count);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,77 @@
+#ifndef REVENUECUBE_H
+#define REVENUECUBE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <cstdint>
+#include "AllCustomers.h"
+#include "AllPurchases.h"
+
+using namespace std;
+
+struct RevenueCell {
+    double revenue{ 0.0 };
+    long count{ 0 }; // number of purchases
+};
+
+// Revenue rolled up by purchase month x brand x customer state.
+// Every purchase is added to all 8 combinations of its (month, brand, state)
+// with each dimension either set or "all", so any roll-up is a single hash
+// lookup and a drill-down is one lookup per member of the dimension, no
+// matter how many purchases there are. Purchase and customer edits update
+// it incrementally; it is saved next to the data files and rebuilt from
+// them if it turns out to be stale, which order-independent checksums of
+// the purchases and customer states (kept up to date with the totals)
+// detect on load.
+class RevenueCube {
+public:
+    enum Dimension { Month, Brand, State };
+    static const string All; // matches every member of a dimension
+
+    // Building
+    void rebuild(const AllCustomers& customers, const AllPurchases& purchases);
+    void addPurchase(const Purchase& p);
+    void removeAccount(int acct);                         // drops every purchase of acct
+    void setCustomerState(int acct, const string& state); // moves acct's revenue to the new state
+
+    // Queries
+    RevenueCell query(const string& month, const string& brand, const string& state) const;
+    // One entry per member of dim, with the other two dimensions fixed as given
+    vector<pair<string, RevenueCell>> drillDown(Dimension dim, const string& month,
+        const string& brand, const string& state) const;
+
+    // File I/O; loadFromFile returns false if the file is missing or doesn't match the data
+    bool saveToFile(const string& filename) const;
+    bool loadFromFile(const string& filename, const AllCustomers& customers, const AllPurchases& purchases);
+
+    static string monthOf(const string& date); // "2025-03-21" -> "2025-03"
+
+private:
+    using MonthBrand = pair<string, string>;
+
+    unordered_map<string, RevenueCell> cells;                // key: month|brand|state, "*" for all
+    set<string> members[3];                                  // every month, brand and state seen
+    unordered_map<int, string> accountState;
+    unordered_map<int, map<MonthBrand, RevenueCell>> byAccount; // lets a state change or delete be undone per account
+    unordered_map<int, uint64_t> accountHash; // sum of purchaseHashOf() per account
+    size_t purchaseCount{ 0 };
+    uint64_t purchaseHash{ 0 };               // sum of purchaseHashOf() over all purchases
+    uint64_t stateHash{ 0 };                  // sum of stateHashOf() over accountState
+
+    void clear();
+    void apply(const string& month, const string& brand, const string& state, double amount, long count);
+    void addToAccount(int acct, const MonthBrand& mb, double amount, long count);
+    string stateOf(int acct) const;
+    static string cellKey(const string& month, const string& brand, const string& state);
+    // Checksums are sums (mod 2^64) of per-record hashes, so they can be
+    // updated incrementally and don't depend on record order
+    static uint64_t purchaseHashOf(const Purchase& p);
+    static uint64_t stateHashOf(int acct, const string& state);
+    bool parse(istream& in, size_t& expectedCount, uint64_t& expectedPurchaseHash,
+        uint64_t& expectedStateHash); // throws on a malformed number
+};
+
+#endif // REVENUECUBE_H
@@ -0,0 +1,18 @@
+#ifndef REVISION_H
+#define REVISION_H
+
+#include <atomic>
+
+using namespace std;
+
+// Revision numbers for AllCustomers and AllPurchases. They all come from
+// one process-wide counter, so two tables with the same revision hold the
+// same records: a copy keeps its source's revision, and every edit, load
+// or assignment takes a number no other table has had. 0 is an empty table.
+inline unsigned long nextRevision()
+{
+    static atomic<unsigned long> counter{ 0 };
+    return counter.fetch_add(1, memory_order_relaxed) + 1;
+}
+
+#endif // REVISION_H